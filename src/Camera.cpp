@@ -1,6 +1,4 @@
 #include "Camera.h"
-#include <chrono>
-#include <thread>
 #include <algorithm>
 #include <fstream>
 #include <cstdlib>
@@ -35,6 +33,19 @@ void Camera::SetPosition(glm::vec3 newPosition)
     UpdateViewMatrix();
 }
 
+// Unprojects the cursor at the near and far planes; works for both projections.
+Ray Camera::GetPickingRay(double mouseX, double mouseY) const
+{
+    float ndcX = static_cast<float>(2.0 * mouseX / m_Width - 1.0);
+    float ndcY = static_cast<float>(1.0 - 2.0 * mouseY / m_Height);
+    glm::mat4 inverseViewProjection = glm::inverse(m_Projection * m_View);
+    glm::vec4 nearPoint = inverseViewProjection * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+    glm::vec4 farPoint = inverseViewProjection * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+    glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+    glm::vec3 direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - origin);
+    return { origin, direction };
+}
+
 //--------------------------------------------------
 // Input Callback Functions (using improved signatures)
 //--------------------------------------------------
@@ -65,9 +76,9 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods
             case GLFW_KEY_Z:     cam->handleZKey(); break;
             case GLFW_KEY_A:     cam->handleAKey(); break;
             case GLFW_KEY_P:     cam->handlePKey(); break;
-            case GLFW_KEY_M:
-                std::thread([cam]() { cam->handleMKey(); }).detach();
-                break;
+            case GLFW_KEY_G:     cam->handleGKey(); break;
+            case GLFW_KEY_F12:   cam->handleF12Key(); break;
+            case GLFW_KEY_M:     cam->handleMKey(); break;
             default:
                 break;
         }
@@ -83,10 +94,37 @@ void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
         return;
     }
 
-    // Report left-button clicks
+    // Report left-button clicks; in picking mode a press on a sticker starts a drag-to-turn gesture
     if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
     {
         std::cout << "Mouse LEFT button pressed." << std::endl;
+        cam->m_TurnGestureActive = false;
+        if (cam->rubiksCube.pickingMode)
+        {
+            double mouseX, mouseY;
+            glfwGetCursorPos(window, &mouseX, &mouseY);
+            RayHit hit;
+            SmallCube* cube = cam->rubiksCube.castRay(cam->GetPickingRay(mouseX, mouseY), &hit);
+            if (cube)
+            {
+                // The hit face is in the cube's own frame; a cube inside a half-turned or turning wall is rotated with it.
+                glm::vec3 normal = glm::mat3(cam->rubiksCube.getTurnedModelMatrix(cube)) * glm::vec3(CubeState::GetFaceNormal(hit.Face));
+                glm::vec3 magnitude = glm::abs(normal);
+                int axis = (magnitude.x >= magnitude.y && magnitude.x >= magnitude.z) ? 0 : (magnitude.y >= magnitude.z ? 1 : 2);
+                cam->m_TurnGesture.Slot = cube->slot;
+                cam->m_TurnGesture.Normal = glm::ivec3(0);
+                cam->m_TurnGesture.Normal[axis] = normal[axis] > 0.0f ? 1 : -1;
+                cam->m_TurnGesture.Point = hit.Point;
+                cam->m_TurnGesture.Cursor = glm::vec2(mouseX, mouseY);
+                cam->m_TurnGestureActive = true;
+                std::cout << "Grabbed sticker " << cam->rubiksCube.cubeState.GetStickerIndex(hit.Face, cube->slot)
+                          << " of cube " << cube->index << std::endl;
+            }
+        }
+    }
+    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_RELEASE)
+    {
+        cam->m_TurnGestureActive = false;
     }
 
     // Right mouse button for picking
@@ -97,34 +135,34 @@ void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
         {
             double mouseX, mouseY;
             glfwGetCursorPos(window, &mouseX, &mouseY);
-            int flippedY = cam->m_Height - static_cast<int>(mouseY);
-
-            unsigned char pickedColor[4] = {0, 0, 0, 0};
-            glReadPixels(static_cast<int>(mouseX), flippedY, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pickedColor);
 
-            int colorID = static_cast<int>(pickedColor[0]);
-            int shapeID = colorID; // decoding strategy
-
-            if (shapeID < 0 || shapeID > 26)
+            if (!cam->m_GPUPicking)
             {
-                cam->rubiksCube.selectedCube = nullptr;
+                // Resolved immediately on the CPU, no render pass or readback involved.
+                RayHit hit;
+                SmallCube* cube = cam->rubiksCube.selectByRay(cam->GetPickingRay(mouseX, mouseY), &hit);
+                if (cube)
+                    std::cout << "Selected cube index: " << cube->index << ", face: " << hit.Face << ", at ("
+                              << hit.Point.x << ", " << hit.Point.y << ", " << hit.Point.z << ")" << std::endl;
+                else
+                    std::cout << "No cube under the cursor." << std::endl;
+                return;
             }
-            else
+
+            // The picking target has the framebuffer's size, which differs from the window size on HiDPI screens.
+            // The read is only queued here; the selection changes once the GPU has delivered the pixel.
+            if (cam->m_PickReadback)
             {
-                for (SmallCube* cube : cam->rubiksCube.smallCubes)
-                {
-                    if (cube->index == shapeID)
-                    {
-                        cam->rubiksCube.selectedCube = cube;
-                        std::cout << "Selected cube index: " << cube->index << std::endl;
-                        break;
-                    }
-                }
+                int pixelX = static_cast<int>(mouseX * cam->m_PickingWidth / cam->m_Width);
+                int pixelY = cam->m_PickingHeight - 1 - static_cast<int>(mouseY * cam->m_PickingHeight / cam->m_Height);
+                cam->m_PickReadback->Request(pixelX, pixelY, [cam](unsigned int objectID) {
+                    int face = -1;
+                    SmallCube* cube = cam->rubiksCube.selectByObjectID(objectID, &face);
+                    if (cube)
+                        std::cout << "Selected cube index: " << cube->index << ", face: " << face << std::endl;
+                    std::cout << "Picked object ID: " << objectID << std::endl;
+                });
             }
-            std::cout << "Picked Color: [R: " << static_cast<int>(pickedColor[0])
-                      << ", G: " << static_cast<int>(pickedColor[1])
-                      << ", B: " << static_cast<int>(pickedColor[2]) << "]" << std::endl;
-            std::cout << "Decoded Shape ID: " << shapeID << std::endl;
         }
     }
 }
@@ -143,25 +181,24 @@ void CursorPosCallback(GLFWwindow* window, double currX, double currY)
     cam->m_OldMouseX = currX;
     cam->m_OldMouseY = currY;
 
-    // Left button: rotate either a selected cube or all cubes.
+    // Left button: turn the layer under a drag that started on a sticker in picking mode, otherwise rotate all cubes.
     if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS)
     {
-        if (cam->rubiksCube.pickingMode)
+        if (cam->m_TurnGestureActive)
         {
-            SmallCube* cube = cam->rubiksCube.selectedCube;
-            if (cube)
+            SmallCube* cube = cam->rubiksCube.centerCube;
+            CubeMove move;
+            if (ResolveTurnGesture(cam->m_TurnGesture, glm::vec2(currX, currY), cube->getRotationMatrix(),
+                                   cam->m_Projection * cam->m_View, glm::vec2(cam->m_Width, cam->m_Height),
+                                   cam->m_TurnGestureDistance, move))
             {
-                float rotAngleY = deltaX * cam->m_RotationSensitivity;
-                float rotAngleX = deltaY * cam->m_RotationSensitivity;
-                glm::mat4 translateToOrigin = glm::translate(glm::mat4(1.0f), -cube->getPosition());
-                glm::mat4 rotX = glm::rotate(glm::mat4(1.0f), glm::radians(rotAngleX), glm::vec3(1.0f, 0.0f, 0.0f));
-                glm::mat4 rotY = glm::rotate(glm::mat4(1.0f), glm::radians(rotAngleY), glm::vec3(0.0f, 1.0f, 0.0f));
-                glm::mat4 translateBack = glm::translate(glm::mat4(1.0f), cube->getPosition());
-                glm::mat4 finalTransform = translateBack * rotY * rotX * translateToOrigin;
-                cube->setModelMatrix(finalTransform * cube->getModelMatrix());
+                // One move per drag; a new press starts the next gesture.
+                cam->m_TurnGestureActive = false;
+                if (!cam->rubiksCube.applyMove(move))
+                    std::cout << "Move refused while another wall is half turned or too many turns wait." << std::endl;
             }
         }
-        else
+        else if (!cam->rubiksCube.pickingMode)
         {
             float rotAngleY = deltaX * cam->m_RotationSensitivity;
             float rotAngleX = glm::clamp(deltaY * cam->m_RotationSensitivity, -89.0f, 89.0f);
@@ -331,9 +368,26 @@ void Camera::handleMKey() {
     int actionCount = 50 + (std::rand() % 50);
     std::cout << "Number of actions to perform: " << actionCount << std::endl;
 
+    // The moves are played by the simulation ticks, on the thread that owns the cube
     for (int i = 0; i < actionCount; ++i) {
         const auto& action = actions[std::rand() % actions.size()];
-        switch (action.first) {
+        m_MixerMoves.push_back(action.first);
+        mixerFile << action.second << std::endl;
+    }
+    m_MixerTimer = m_MixerInterval;
+    mixerFile.close();
+    std::cout << "Mixer actions have been written to mixer.txt." << std::endl;
+}
+
+void Camera::Update(float dt)
+{
+    if (m_MixerMoves.empty())
+        return;
+
+    m_MixerTimer += dt;
+    while (!m_MixerMoves.empty() && m_MixerTimer >= m_MixerInterval) {
+        m_MixerTimer -= m_MixerInterval;
+        switch (m_MixerMoves.front()) {
             case 'R': handleRKey(); break;
             case 'L': handleLKey(); break;
             case 'U': handleUKey(); break;
@@ -341,11 +395,8 @@ void Camera::handleMKey() {
             case 'B': handleBKey(); break;
             case 'F': handleFKey(); break;
         }
-        mixerFile << action.second << std::endl;
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        m_MixerMoves.pop_front();
     }
-    mixerFile.close();
-    std::cout << "Mixer actions have been written to mixer.txt." << std::endl;
 }
 
 void Camera::handlePKey()
@@ -355,6 +406,18 @@ void Camera::handlePKey()
     std::cout << "Picking mode is now: " << rubiksCube.pickingMode << std::endl;
 }
 
+void Camera::handleGKey()
+{
+    m_GPUPicking = !m_GPUPicking;
+    std::cout << "G key pressed - picking now uses " << (m_GPUPicking ? "GPU object IDs." : "CPU ray casts.") << std::endl;
+}
+
+void Camera::handleF12Key()
+{
+    m_ScreenshotRequested = true;
+    std::cout << "F12 key pressed - taking a screenshot." << std::endl;
+}
+
 //--------------------------------------------------
 // Arrow Key Handlers for Rubik's Cube Movement
 //--------------------------------------------------
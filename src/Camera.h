@@ -10,10 +10,13 @@
 #include <glm/gtx/rotate_vector.hpp>
 #include <glm/gtx/vector_angle.hpp>
 #include <iostream>
+#include <deque>
 #include <vector>
 #include "Debugger.h"
 #include "Shader.h"
 #include "RubiksCube.h"
+#include "PickReadback.h"
+#include "TurnGesture.h"
 
 class Camera
 {
@@ -25,6 +28,23 @@ public:
     // Rubik's Cube reference (holds cube data and behavior)
     RubiksCube& rubiksCube;
 
+    // The scene's object IDs are read back on right-click in picking mode when m_GPUPicking is
+    // set, from a target of m_PickingWidth x m_PickingHeight pixels that the render thread owns.
+    // Otherwise clicks are resolved on the CPU by casting a ray through the cursor.
+    PickReadback* m_PickReadback = nullptr;
+    int m_PickingWidth = 0;
+    int m_PickingHeight = 0;
+    bool m_GPUPicking = false;
+
+    // Set by F12; the render loop takes a tiled high-resolution screenshot and clears it
+    bool m_ScreenshotRequested = false;
+
+    // Drag-to-turn: set by a left press on a sticker in picking mode, resolved into a layer move
+    // once the cursor has moved far enough
+    TurnGestureStart m_TurnGesture;
+    bool m_TurnGestureActive = false;
+    float m_TurnGestureDistance = 10.0f; // Pixels
+
     // Camera transformation parameters
     glm::vec3 m_Position = glm::vec3(0.0f, 0.0f, 0.0f);
     glm::vec3 m_Orientation = glm::vec3(0.0f, 0.0f, -1.0f); // Forward vector
@@ -58,6 +78,12 @@ public:
     // Mouse rotation sensitivity
     float m_RotationSensitivity = 0.1f;
 
+    // Wall turns requested by the Mixer ('R', 'L', 'U', 'D', 'B' or 'F'), played by Update one
+    // every m_MixerInterval seconds of simulation time
+    std::deque<char> m_MixerMoves;
+    float m_MixerInterval = 0.05f;
+    float m_MixerTimer = 0.0f;
+
     // Constructor
     Camera(int width, int height, RubiksCube& cubeRef)
             : m_Width(width), m_Height(height), rubiksCube(cubeRef) {}
@@ -70,9 +96,15 @@ public:
     // Input and view update methods
     void EnableInputs(GLFWwindow* window);
     void UpdateViewMatrix();
+
+    // Simulation tick of 'dt' seconds: plays the Mixer's moves
+    void Update(float dt);
     inline glm::mat4 GetViewMatrix() const { return m_View; }
     inline glm::mat4 GetProjectionMatrix() const { return m_Projection; }
 
+    // World-space ray from the camera through the given window position (in screen coordinates)
+    Ray GetPickingRay(double mouseX, double mouseY) const;
+
     // Rubik's Cube interaction handlers
     void handleRKey();
     void handleLKey();
@@ -92,6 +124,10 @@ public:
 
     // Picking mode handler
     void handlePKey();
+    void handleGKey();
+
+    // Screenshot handler
+    void handleF12Key();
 
     // Mixer bonus handler
     void handleMKey();
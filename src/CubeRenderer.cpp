@@ -0,0 +1,116 @@
+#include <CubeRenderer.h>
+#include <RubiksCube.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cstring>
+
+// Uniforms set on every draw, resolved once.
+static const Uniform u_Color("u_Color");
+static const Uniform u_CubieIndex("u_CubieIndex");
+static const Uniform u_Model("u_Model");
+
+// Angle of the layer being turned, between the snapshot's last two ticks.
+static float GetTurnAngle(const CubeSnapshot& cube, float alpha)
+{
+    return cube.PreviousTurnAngle + (cube.TurnAngle - cube.PreviousTurnAngle) * alpha;
+}
+
+CubeRenderer::CubeRenderer(unsigned int stickerCount, unsigned int cubeCount)
+    : m_StickerBuffer(stickerCount), m_TransformBuffer(cubeCount), m_LastTransformUploadBytes(0)
+{
+}
+
+void CubeRenderer::Draw(const CubeSnapshot& cube, Shader& shader, VertexArray& va, StickerMesh& mesh, float alpha)
+{
+    // Re-upload the sticker colors only after a wall finished a quarter turn.
+    if (m_Stickers != cube.Stickers)
+    {
+        m_StickerBuffer.Update(cube.Stickers.data(), (unsigned int) cube.Stickers.size());
+        m_Stickers = cube.Stickers;
+    }
+    m_StickerBuffer.Bind(1);
+
+    // The layer being turned is drawn at its angle between the last two simulation ticks.
+    float angle = GetTurnAngle(cube, alpha);
+    glm::mat4 turn = RubiksCube::getLayerRotation(cube.Center, cube.TurnAxis, angle);
+
+    // Send the transforms that differ from the last upload, one upload per run of neighboring
+    // cubes. Cube indices double as buffer positions.
+    size_t count = cube.Models.size();
+    m_Transforms.resize(count, glm::mat4(0.0f));
+    m_LastTransformUploadBytes = 0;
+    size_t runStart = 0;
+    for (size_t i = 0; i <= count; i++)
+    {
+        bool changed = false;
+        if (i < count)
+        {
+            glm::mat4 model = angle != 0.0f && cube.Turning[i] ? turn * cube.Models[i] : cube.Models[i];
+            glm::mat4 transform = cube.Rotations[i] * model;
+            changed = std::memcmp(&transform, &m_Transforms[i], sizeof(glm::mat4)) != 0;
+            if (changed)
+                m_Transforms[i] = transform;
+        }
+        if (changed)
+            continue;
+
+        if (i > runStart)
+        {
+            unsigned int run = (unsigned int) (i - runStart);
+            m_TransformBuffer.Update(&m_Transforms[runStart], run, (unsigned int) runStart);
+            m_LastTransformUploadBytes += run * (unsigned int) sizeof(glm::mat4);
+        }
+        runStart = i + 1;
+    }
+    m_TransformBuffer.Bind(2);
+
+    // Faces between cubies are hidden unless a wall is turning or stuck part way through a turn.
+    bool midTurn = angle != 0.0f || cube.HalfTurned;
+
+    shader.Bind();
+    glm::vec4 color(1.0f);
+    shader.SetUniform4f(u_Color, color);
+    va.Bind();
+    mesh.Bind();
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const CubieRange& range = mesh.GetRange(cube.Slots[i]);
+        unsigned int indexCount = midTurn ? range.Count : range.VisibleCount;
+        if (indexCount == 0)
+            continue; // The center cube
+
+        shader.SetUniform1i(u_CubieIndex, (int) i);
+        GLCall(glDrawElements(GL_TRIANGLES, indexCount, mesh.GetIndexType(), mesh.GetIndexOffset(range)));
+    }
+}
+
+void CubeRenderer::DrawSelection(const CubeSnapshot& cube, Shader& shader, VertexArray& va, StickerMesh& mesh, float alpha)
+{
+    if (cube.Selected < 0)
+        return;
+
+    // Where Draw put the cube, slightly enlarged so the outline is not hidden by its own faces.
+    glm::mat4 model = cube.Models[cube.Selected];
+    float angle = GetTurnAngle(cube, alpha);
+    if (angle != 0.0f && cube.Turning[cube.Selected])
+        model = RubiksCube::getLayerRotation(cube.Center, cube.TurnAxis, angle) * model;
+    model = cube.Rotations[cube.Selected] * model;
+    glm::mat4 outlineModel = glm::scale(model, glm::vec3(1.02f));
+    glm::vec4 outlineColor(1.0f, 0.0f, 1.0f, 1.0f);
+
+    shader.Bind();
+    shader.SetUniform4f(u_Color, outlineColor);
+    shader.SetUniformMat4f(u_Model, outlineModel);
+
+    const CubieRange& range = mesh.GetRange(cube.Slots[cube.Selected]);
+    va.Bind();
+    mesh.Bind();
+    // The outline is not pickable, so it must leave the object ID attachment untouched.
+    GLCall(glColorMaski(1, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
+    GLCall(glPolygonMode(GL_FRONT_AND_BACK, GL_LINE));
+    GLCall(glDrawElements(GL_TRIANGLES, range.Count, mesh.GetIndexType(), mesh.GetIndexOffset(range)));
+    GLCall(glPolygonMode(GL_FRONT_AND_BACK, GL_FILL));
+    GLCall(glColorMaski(1, GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE));
+}
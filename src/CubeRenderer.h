@@ -0,0 +1,42 @@
+#pragma once
+
+#include <FrameSnapshot.h>
+#include <Shader.h>
+#include <StickerBuffer.h>
+#include <StickerMesh.h>
+#include <TransformBuffer.h>
+#include <VertexArray.h>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// Draws the cube from a CubeSnapshot on the render thread. The sticker colors and transforms
+// persist on the GPU; a CPU copy of what was uploaded last decides what has to be sent again,
+// which stays correct however many snapshots were skipped in between.
+class CubeRenderer
+{
+    private:
+        StickerBuffer m_StickerBuffer;
+        TransformBuffer m_TransformBuffer;
+        std::vector<unsigned char> m_Stickers;
+        std::vector<glm::mat4> m_Transforms;
+        unsigned int m_LastTransformUploadBytes;
+    public:
+        CubeRenderer(unsigned int stickerCount, unsigned int cubeCount);
+
+        CubeRenderer(const CubeRenderer&) = delete;
+        CubeRenderer& operator=(const CubeRenderer&) = delete;
+
+        // Scene pass: draws the cube into the bound framebuffer, together with the object ID of
+        // every fragment when the framebuffer has an ID attachment. 'alpha' places the frame
+        // between the snapshot's previous (0) and latest (1) tick.
+        void Draw(const CubeSnapshot& cube, Shader& shader, VertexArray& va, StickerMesh& mesh, float alpha);
+
+        // Overlay pass: outlines the selected cube on top of the scene, turned like Draw turns it
+        // at the same 'alpha'.
+        void DrawSelection(const CubeSnapshot& cube, Shader& shader, VertexArray& va, StickerMesh& mesh, float alpha);
+
+        // Bytes of cube transforms sent to the GPU by the last Draw (zero when nothing moved).
+        inline unsigned int GetLastTransformUploadBytes() const { return m_LastTransformUploadBytes; }
+};
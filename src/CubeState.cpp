@@ -0,0 +1,181 @@
+#include <CubeState.h>
+
+#include <map>
+#include <mutex>
+
+// Rotates an integer vector by 90 degrees counterclockwise around the given axis.
+static glm::ivec3 RotateQuarter(const glm::ivec3& v, int axis)
+{
+    switch (axis)
+    {
+    case 0:
+        return glm::ivec3(v.x, -v.z, v.y);
+    case 1:
+        return glm::ivec3(v.z, v.y, -v.x);
+    default:
+        return glm::ivec3(-v.y, v.x, v.z);
+    }
+}
+
+// Direction the top of a sticker's texture points to on 'face' at the given orientation. The
+// texture axes are those of StickerMesh: u along x (z on the sides), v along y (z on top and
+// bottom).
+static glm::ivec3 GetTextureUp(int face, int orientation)
+{
+    glm::ivec3 normal = CubeState::GetFaceNormal(face);
+    int axis = normal.x != 0 ? 0 : (normal.y != 0 ? 1 : 2);
+    int u = axis == 0 ? 2 : 0;
+    int v = axis == 1 ? 2 : 1;
+
+    glm::ivec3 up(0);
+    switch (orientation & 3)
+    {
+    case 0: up[v] = 1; break;
+    case 1: up[u] = -1; break;
+    case 2: up[v] = -1; break;
+    default: up[u] = 1; break;
+    }
+    return up;
+}
+
+static int GetFaceFromNormal(const glm::ivec3& normal)
+{
+    for (int face = 0; face < FACE_COUNT; face++)
+    {
+        if (CubeState::GetFaceNormal(face) == normal)
+            return face;
+    }
+    return -1;
+}
+
+// Maps a slot to the (u, v) coordinates it occupies on the given face.
+static glm::ivec2 GetFaceCoords(int face, const glm::ivec3& slot)
+{
+    if (face == FACE_FRONT || face == FACE_BACK)
+        return glm::ivec2(slot.x, slot.y);
+    if (face == FACE_LEFT || face == FACE_RIGHT)
+        return glm::ivec2(slot.z, slot.y);
+    return glm::ivec2(slot.x, slot.z);
+}
+
+static int GetStickerIndex(int size, int face, const glm::ivec3& slot)
+{
+    glm::ivec3 normal = CubeState::GetFaceNormal(face);
+    int axis = normal.x != 0 ? 0 : (normal.y != 0 ? 1 : 2);
+    int boundary = normal[axis] > 0 ? size - 1 : 0;
+    if (slot[axis] != boundary)
+        return -1;
+
+    glm::ivec2 uv = GetFaceCoords(face, slot);
+    return face * size * size + uv.y * size + uv.x;
+}
+
+CubeState::CubeState(int size)
+    : m_Size(size), m_Stickers(FACE_COUNT * size * size), m_Scratch(FACE_COUNT * size * size),
+      m_TurnTables(GetTurnTables(size)), m_Dirty(true)
+{
+    Reset();
+}
+
+void CubeState::Reset()
+{
+    const int faceSize = m_Size * m_Size;
+    for (int i = 0; i < (int) m_Stickers.size(); i++)
+        m_Stickers[i] = (unsigned char) (i / faceSize);
+    m_Dirty = true;
+}
+
+glm::ivec3 CubeState::GetFaceNormal(int face)
+{
+    switch (face)
+    {
+    case FACE_FRONT: return glm::ivec3(0, 0, 1);
+    case FACE_BACK:  return glm::ivec3(0, 0, -1);
+    case FACE_LEFT:  return glm::ivec3(-1, 0, 0);
+    case FACE_RIGHT: return glm::ivec3(1, 0, 0);
+    case FACE_UP:    return glm::ivec3(0, 1, 0);
+    case FACE_DOWN:  return glm::ivec3(0, -1, 0);
+    }
+    return glm::ivec3(0);
+}
+
+int CubeState::GetStickerIndex(int face, const glm::ivec3& slot) const
+{
+    return ::GetStickerIndex(m_Size, face, slot);
+}
+
+std::shared_ptr<const CubeState::TurnTables> CubeState::GetTurnTables(int size)
+{
+    static std::mutex mutex;
+    static std::map<int, std::shared_ptr<const TurnTables>> cache;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<const TurnTables>& cached = cache[size];
+    if (cached)
+        return cached;
+
+    std::shared_ptr<TurnTables> tables = std::make_shared<TurnTables>(3 * size);
+    const int faceSize = size * size;
+    for (int i = 0; i < FACE_COUNT * faceSize; i++)
+    {
+        int face = i / faceSize;
+        int u = i % size;
+        int v = (i % faceSize) / size;
+
+        // Recover the slot the sticker sits on from its face coordinates.
+        glm::ivec3 normal = GetFaceNormal(face);
+        int normalAxis = normal.x != 0 ? 0 : (normal.y != 0 ? 1 : 2);
+        glm::ivec3 slot;
+        if (normalAxis == 2)
+            slot = glm::ivec3(u, v, 0);
+        else if (normalAxis == 0)
+            slot = glm::ivec3(0, v, u);
+        else
+            slot = glm::ivec3(u, 0, v);
+        slot[normalAxis] = normal[normalAxis] > 0 ? size - 1 : 0;
+
+        for (int axis = 0; axis < 3; axis++)
+        {
+            // Rotate around the cube center using doubled coordinates so even sizes stay integral.
+            glm::ivec3 centered = slot * 2 - glm::ivec3(size - 1);
+            glm::ivec3 rotated = (RotateQuarter(centered, axis) + glm::ivec3(size - 1)) / 2;
+            int newFace = GetFaceFromNormal(RotateQuarter(normal, axis));
+            StickerMove move;
+            move.From = i;
+            move.To = ::GetStickerIndex(size, newFace, rotated);
+
+            // The turn carries the top of the texture along; find it again on the new face
+            for (int orientation = 0; orientation < 4; orientation++)
+            {
+                glm::ivec3 up = RotateQuarter(GetTextureUp(face, orientation), axis);
+                int arrival = 0;
+                while (GetTextureUp(newFace, arrival) != up)
+                    arrival++;
+                move.Orientations[orientation] = (unsigned char) arrival;
+            }
+            (*tables)[axis * size + slot[axis]].push_back(move);
+        }
+    }
+    cached = tables;
+    return cached;
+}
+
+void CubeState::ApplyQuarterTurn(int axis, int layer, int quarterTurns)
+{
+    quarterTurns = ((quarterTurns % 4) + 4) % 4;
+    if (quarterTurns == 0)
+        return;
+
+    const std::vector<StickerMove>& moves = (*m_TurnTables)[axis * m_Size + layer];
+    for (int turn = 0; turn < quarterTurns; turn++)
+    {
+        for (const StickerMove& move : moves)
+        {
+            unsigned char sticker = m_Stickers[move.From];
+            unsigned char orientation = move.Orientations[sticker >> ORIENTATION_SHIFT];
+            m_Scratch[move.To] = (unsigned char) ((sticker & COLOR_MASK) | orientation << ORIENTATION_SHIFT);
+        }
+        for (const StickerMove& move : moves)
+            m_Stickers[move.To] = m_Scratch[move.To];
+    }
+    m_Dirty = true;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <memory>
+#include <vector>
+
+// Face order matches the vertex data in main.cpp and the sticker lookup in basic.shader.
+enum CubeFace
+{
+    FACE_FRONT = 0, // +Z
+    FACE_BACK,      // -Z
+    FACE_LEFT,      // -X
+    FACE_RIGHT,     // +X
+    FACE_UP,        // +Y
+    FACE_DOWN,      // -Y
+    FACE_COUNT
+};
+
+// A turn of one layer: 'Layer' runs from 0 to N - 1 along 'Axis' (0 = X, 1 = Y, 2 = Z) and the
+// layer turns QuarterTurns * 90 degrees counterclockwise around the positive axis.
+struct CubeMove
+{
+    int Axis;
+    int Layer;
+    int QuarterTurns;
+};
+
+// Logical cube state: one byte per sticker, 6 * N * N bytes in total.
+// Sticker (face, u, v) lives at face * N * N + v * N + u, where (u, v) are the slot
+// coordinates spanning the face: (x, y) for front/back, (z, y) for left/right and
+// (x, z) for up/down. Slots run from 0 to N - 1 along every axis.
+// The low three bits of a sticker hold its color index, bits 3 and 4 how far it has been turned
+// on its face (see GetOrientation); the shaders read the bytes as they are.
+class CubeState
+{
+    private:
+        // A sticker moved by a quarter turn, and the orientation it arrives with for each of the
+        // four it may leave with
+        struct StickerMove
+        {
+            int From, To;
+            unsigned char Orientations[4];
+        };
+
+        // For every (axis, layer), the sticker moves of one quarter turn. Shared by all states of
+        // the same size.
+        typedef std::vector<std::vector<StickerMove>> TurnTables;
+
+        int m_Size;
+        std::vector<unsigned char> m_Stickers;
+        std::vector<unsigned char> m_Scratch;
+        std::shared_ptr<const TurnTables> m_TurnTables;
+        bool m_Dirty;
+
+        static std::shared_ptr<const TurnTables> GetTurnTables(int size);
+    public:
+        CubeState(int size = 3);
+
+        // Restores the solved state (every sticker takes the color of its face).
+        void Reset();
+
+        // Turns the layer at 'layer' along 'axis' (0 = X, 1 = Y, 2 = Z) by quarterTurns * 90
+        // degrees, counterclockwise around the positive axis (same sense as glm::rotate).
+        void ApplyQuarterTurn(int axis, int layer, int quarterTurns);
+
+        // Returns the sticker index for the given face of the cubie at 'slot', or -1 when
+        // that face is inside the puzzle and carries no sticker.
+        int GetStickerIndex(int face, const glm::ivec3& slot) const;
+
+        static glm::ivec3 GetFaceNormal(int face);
+
+        inline int GetSize() const { return m_Size; }
+        inline unsigned int GetStickerCount() const { return (unsigned int) m_Stickers.size(); }
+        inline const unsigned char* GetStickers() const { return m_Stickers.data(); }
+        inline unsigned char GetSticker(unsigned int index) const { return m_Stickers[index] & COLOR_MASK; }
+
+        // Quarter turns (0 to 3) the sticker's texture is turned by on its face. At 0 the top of
+        // the texture points along +v of the face (see StickerMesh), at 1 along -u, then -v and +u.
+        // Only the direction of the top is tracked, which covers textures that are symmetric
+        // left to right; the mesh mirrors the texture on half of the faces anyway.
+        inline int GetOrientation(unsigned int index) const { return m_Stickers[index] >> ORIENTATION_SHIFT; }
+
+        static const unsigned char COLOR_MASK = 7;
+        static const int ORIENTATION_SHIFT = 3;
+
+        // Set whenever the stickers change, so the GPU copy is only refreshed when needed.
+        inline bool IsDirty() const { return m_Dirty; }
+        inline void ClearDirty() { m_Dirty = false; }
+};
@@ -1,4 +1,17 @@
 #include <Debugger.h>
+#include <GLExtensions.h>
+
+// Most recent GLCall site, reported alongside debug messages. Debug output is synchronous, so the
+// callback runs inside the offending call, on the thread that made it.
+struct GLCallSite
+{
+    const char* Function = "";
+    const char* File = "";
+    int Line = 0;
+};
+
+static GLCallSite s_LastCall;
+static bool s_DebugOutput = false;
 
 void GLClearError()
 {
@@ -13,4 +26,46 @@ bool GLLogCall(const char* function, const char* file, int line)
         return false;
     }
     return true;
-}
\ No newline at end of file
+}
+
+void GLBeginCall(const char* function, const char* file, int line)
+{
+    s_LastCall.Function = function;
+    s_LastCall.File = file;
+    s_LastCall.Line = line;
+    if (!s_DebugOutput)
+        GLClearError();
+}
+
+bool GLEndCall()
+{
+    if (s_DebugOutput)
+        return true;
+    return GLLogCall(s_LastCall.Function, s_LastCall.File, s_LastCall.Line);
+}
+
+static void APIENTRY GLDebugMessage(GLenum source, GLenum type, GLuint id, GLenum severity,
+                                    GLsizei length, const GLchar* message, const void* userParam)
+{
+    // Compile errors are printed from the info log by Shader, and a broken shader is not a bug
+    // in the program: the resource cache keeps the previous version after a failed reload
+    if (severity == GL_DEBUG_SEVERITY_NOTIFICATION || source == GL_DEBUG_SOURCE_SHADER_COMPILER)
+        return;
+
+    const char* label = type == GL_DEBUG_TYPE_ERROR ? "[OpenGL Error]" : "[OpenGL Debug]";
+    std::cout << label << " (" << id << "): " << message << std::endl;
+    std::cout << "    near " << s_LastCall.Function << " " << s_LastCall.File << ":" << s_LastCall.Line << std::endl;
+    ASSERT(type != GL_DEBUG_TYPE_ERROR);
+}
+
+bool GLEnableDebugOutput()
+{
+    if (!GLExt.KHR_debug)
+        return false;
+
+    glEnable(GL_DEBUG_OUTPUT);
+    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS); // Otherwise the driver may report from its own thread
+    GLExt.DebugMessageCallback(GLDebugMessage, nullptr);
+    s_DebugOutput = true;
+    return true;
+}
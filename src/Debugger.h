@@ -18,9 +18,22 @@
 #define ASSERT(x) if (!(x)) raise(SIGTRAP);
 #endif
 
-#define GLCall(x) GLClearError();\
+// Release builds (make BUILD=release, which defines NDEBUG) compile GLCall down to the bare call.
+// Debug builds record the call site; errors then arrive through the KHR_debug callback when
+// GLEnableDebugOutput() succeeded, and fall back to glGetError() polling otherwise (e.g. macOS).
+#ifdef NDEBUG
+#define GLCall(x) x
+#else
+#define GLCall(x) GLBeginCall(#x, __FILE__, __LINE__);\
     x;\
-    ASSERT(GLLogCall(#x, __FILE__, __LINE__));
+    ASSERT(GLEndCall());
+#endif
 
 void GLClearError();
-bool GLLogCall(const char* function, const char* file, int line);
\ No newline at end of file
+bool GLLogCall(const char* function, const char* file, int line);
+
+void GLBeginCall(const char* function, const char* file, int line);
+bool GLEndCall();
+
+// Installs the KHR_debug message callback; returns false when the context does not support it.
+bool GLEnableDebugOutput();
@@ -0,0 +1,33 @@
+#include <FixedTimestep.h>
+
+#include <cmath>
+
+FixedTimestep::FixedTimestep(double ticksPerSecond, unsigned int maxTicks)
+    : m_TickLength(1.0 / ticksPerSecond), m_Accumulator(0.0), m_LastTime(0.0), m_MaxTicks(maxTicks),
+      m_TickCount(0)
+{
+}
+
+void FixedTimestep::Reset(double now)
+{
+    m_LastTime = now;
+    m_Accumulator = 0.0;
+}
+
+unsigned int FixedTimestep::Advance(double now)
+{
+    m_Accumulator += now - m_LastTime;
+    m_LastTime = now;
+
+    unsigned int ticks = 0;
+    while (m_Accumulator >= m_TickLength && ticks < m_MaxTicks)
+    {
+        m_Accumulator -= m_TickLength;
+        ticks++;
+    }
+    if (m_Accumulator >= m_TickLength)
+        m_Accumulator = std::fmod(m_Accumulator, m_TickLength);
+
+    m_TickCount += ticks;
+    return ticks;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+// Fixed-rate simulation clock. Advance() turns the real time that has passed into whole ticks;
+// what is left over, as a fraction of a tick, is where the frame lies between the previous and
+// the latest tick and is used to interpolate what is drawn. The simulation therefore runs at the
+// same rate whatever the frame rate or the monitor's refresh rate.
+class FixedTimestep
+{
+    private:
+        double m_TickLength;
+        double m_Accumulator;
+        double m_LastTime;
+        unsigned int m_MaxTicks;
+        unsigned long long m_TickCount;
+    public:
+        // 'maxTicks' bounds the ticks run by one Advance(); time beyond that is dropped, so a
+        // long stall slows the simulation down instead of making every later frame catch up.
+        FixedTimestep(double ticksPerSecond, unsigned int maxTicks = 8);
+
+        // Starts counting at 'now' (seconds), discarding any time not simulated yet.
+        void Reset(double now);
+
+        // Returns the number of ticks to run up to 'now' (seconds).
+        unsigned int Advance(double now);
+
+        // Fraction of a tick the frame lies past the latest tick, in [0, 1).
+        inline float GetAlpha() const { return (float) (m_Accumulator / m_TickLength); }
+        inline float GetTickLength() const { return (float) m_TickLength; }
+        inline unsigned long long GetTickCount() const { return m_TickCount; }
+};
@@ -0,0 +1,378 @@
+#include <stb/stb_image_write.h>
+
+#include <FrameCapture.h>
+#include <RenderState.h>
+
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+FrameCapture::FrameCapture(const std::string& path, unsigned int threadCount, unsigned int framesPerSecond)
+    : m_Format(GetFormat(path)), m_Path(path), m_Stream(nullptr), m_IsPipe(false),
+      m_FramesPerSecond(framesPerSecond), m_StreamWidth(0), m_StreamHeight(0), m_NextSlot(0),
+      m_FrameCount(0), m_MaxFrames(0), m_NextSequence(0), m_WriteSequence(0), m_Stopping(false), m_WriteFailed(false)
+{
+    if (m_Format == CaptureFormat::Y4M)
+    {
+        if (!path.empty() && path[0] == '|')
+        {
+#ifdef _WIN32
+            m_Stream = popen(path.c_str() + 1, "wb");
+#else
+            // A command that exits early must fail the writes, not end the program
+            std::signal(SIGPIPE, SIG_IGN);
+            m_Stream = popen(path.c_str() + 1, "w");
+#endif
+            m_IsPipe = true;
+        }
+        else
+        {
+            m_Stream = std::fopen(path.c_str(), "wb");
+        }
+        if (!m_Stream)
+        {
+            std::cerr << "Capture: failed to open " << path << std::endl;
+            return;
+        }
+    }
+
+    for (Slot& slot : m_Slots)
+    {
+        GLCall(glGenBuffers(1, &slot.Buffer));
+    }
+
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency() / 2);
+    // Enough frames for every writer to work on one while another waits, plus the readbacks
+    m_MaxFrames = 2 * threadCount + SLOT_COUNT;
+    for (unsigned int i = 0; i < threadCount; i++)
+        m_Workers.emplace_back(&FrameCapture::WorkerLoop, this);
+}
+
+FrameCapture::~FrameCapture()
+{
+    Flush();
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_Condition.notify_all();
+    for (std::thread& worker : m_Workers)
+        worker.join();
+
+    for (Slot& slot : m_Slots)
+    {
+        if (slot.Fence)
+        {
+            GLCall(glDeleteSync(slot.Fence));
+        }
+        if (slot.Buffer)
+            RenderState::DeleteBuffer(slot.Buffer);
+    }
+    for (Frame* frame : m_FreeFrames)
+        delete frame;
+
+    if (m_Stream)
+    {
+        if (m_IsPipe)
+            pclose(m_Stream);
+        else
+            std::fclose(m_Stream);
+    }
+}
+
+CaptureFormat FrameCapture::GetFormat(const std::string& path)
+{
+    if (!path.empty() && path[0] == '|')
+        return CaptureFormat::Y4M;
+
+    std::string extension = path.substr(std::min(path.size(), path.find_last_of('.')));
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension == ".y4m")
+        return CaptureFormat::Y4M;
+    if (extension == ".raw")
+        return CaptureFormat::Raw;
+    return CaptureFormat::PNG;
+}
+
+void FrameCapture::Capture(const Framebuffer& source)
+{
+    if (!IsValid())
+        return;
+
+    unsigned int index;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        index = m_Stats.Frames++;
+    }
+    Collect(false);
+
+    // The copy from two frames ago is still running: skip this frame rather than wait for it
+    Slot& slot = m_Slots[m_NextSlot];
+    if (slot.Fence)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stats.Dropped++;
+        return;
+    }
+
+    // With a pack buffer bound, glReadPixels only schedules the copy
+    unsigned int size = (unsigned int) source.GetWidth() * source.GetHeight() * 4;
+    RenderState::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+    if (slot.Size != size)
+    {
+        GLCall(glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ));
+        slot.Size = size;
+    }
+    source.ReadPixelsAsync();
+    GLCall(slot.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    RenderState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.Width = source.GetWidth();
+    slot.Height = source.GetHeight();
+    slot.Index = index;
+    m_NextSlot = (m_NextSlot + 1) % SLOT_COUNT;
+}
+
+void FrameCapture::Flush()
+{
+    Collect(true);
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_FrameDone.wait(lock, [this]() { return m_FreeFrames.size() == m_FrameCount; });
+}
+
+CaptureStats FrameCapture::GetStats()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Stats;
+}
+
+void FrameCapture::Collect(bool wait)
+{
+    // Fences signal in order, so the slots are visited from the oldest copy on
+    for (int i = 0; i < SLOT_COUNT; i++)
+    {
+        Slot& slot = m_Slots[(m_NextSlot + i) % SLOT_COUNT];
+        if (!slot.Fence)
+            continue;
+
+        if (wait)
+        {
+            GLenum result;
+            do
+            {
+                GLCall(result = glClientWaitSync(slot.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000));
+            } while (result == GL_TIMEOUT_EXPIRED);
+        }
+        else
+        {
+            GLint status = GL_UNSIGNALED;
+            GLCall(glGetSynciv(slot.Fence, GL_SYNC_STATUS, 1, nullptr, &status));
+            if (status != GL_SIGNALED)
+                break;
+        }
+
+        Frame* frame = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            if (wait)
+                m_FrameDone.wait(lock, [this]() { return !m_FreeFrames.empty() || m_FrameCount < m_MaxFrames; });
+
+            if (!m_FreeFrames.empty())
+            {
+                frame = m_FreeFrames.back();
+                m_FreeFrames.pop_back();
+            }
+            else if (m_FrameCount < m_MaxFrames)
+            {
+                frame = new Frame();
+                m_FrameCount++;
+            }
+            else
+            {
+                // Every writer is busy and the queue is full
+                m_Stats.Dropped++;
+            }
+        }
+
+        if (frame)
+        {
+            frame->Width = slot.Width;
+            frame->Height = slot.Height;
+            frame->Index = slot.Index;
+            frame->Pixels.resize(slot.Size);
+
+            // Rows come back bottom first; the files and the stream want them top first
+            const unsigned char* pixels;
+            size_t rowSize = (size_t) slot.Width * 4;
+            RenderState::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+            GLCall(pixels = (const unsigned char*) glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, slot.Size, GL_MAP_READ_BIT));
+            for (int y = 0; y < slot.Height; y++)
+                std::memcpy(&frame->Pixels[y * rowSize], pixels + (slot.Height - 1 - y) * rowSize, rowSize);
+            GLCall(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+            RenderState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                frame->Sequence = m_NextSequence++;
+                m_Queue.push_back(frame);
+            }
+            m_Condition.notify_one();
+        }
+
+        GLCall(glDeleteSync(slot.Fence));
+        slot.Fence = nullptr;
+    }
+}
+
+void FrameCapture::WorkerLoop()
+{
+    std::vector<unsigned char> planes;
+    while (true)
+    {
+        Frame* frame;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Condition.wait(lock, [this]() { return m_Stopping || !m_Queue.empty(); });
+            // Frames still queued when stopping are written first
+            if (m_Queue.empty())
+                return;
+            frame = m_Queue.front();
+            m_Queue.pop_front();
+        }
+
+        bool written = m_Format == CaptureFormat::Y4M ? WriteStream(*frame, planes) : Write(*frame);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (written)
+                m_Stats.Written++;
+            else
+                m_Stats.Dropped++;
+            m_FreeFrames.push_back(frame);
+        }
+        m_FrameDone.notify_all();
+    }
+}
+
+std::string FrameCapture::GetFramePath(unsigned int index) const
+{
+    char number[16];
+    std::snprintf(number, sizeof(number), "_%06u", index);
+
+    size_t separator = m_Path.find_last_of("/\\");
+    size_t dot = m_Path.find_last_of('.');
+    if (dot == std::string::npos || (separator != std::string::npos && dot < separator))
+        return m_Path + number;
+    return m_Path.substr(0, dot) + number + m_Path.substr(dot);
+}
+
+bool FrameCapture::Write(const Frame& frame)
+{
+    std::string path = GetFramePath(frame.Index);
+    bool written;
+    if (m_Format == CaptureFormat::PNG)
+    {
+        written = stbi_write_png(path.c_str(), frame.Width, frame.Height, 4, frame.Pixels.data(), frame.Width * 4) != 0;
+    }
+    else
+    {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        written = file && std::fwrite(frame.Pixels.data(), 1, frame.Pixels.size(), file) == frame.Pixels.size();
+        if (file)
+            written = std::fclose(file) == 0 && written;
+    }
+
+    if (!written)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (!m_WriteFailed)
+            std::cerr << "Capture: failed to write " << path << std::endl;
+        m_WriteFailed = true;
+    }
+    return written;
+}
+
+bool FrameCapture::WriteStream(const Frame& frame, std::vector<unsigned char>& planes)
+{
+    // Full range BT.601 (the "C420jpeg" chroma siting), with the chroma of each 2x2 block averaged
+    int width = frame.Width, height = frame.Height;
+    int chromaWidth = (width + 1) / 2, chromaHeight = (height + 1) / 2;
+    planes.resize((size_t) width * height + 2 * (size_t) chromaWidth * chromaHeight);
+    unsigned char* luma = planes.data();
+    unsigned char* cb = luma + (size_t) width * height;
+    unsigned char* cr = cb + (size_t) chromaWidth * chromaHeight;
+
+    const unsigned char* pixels = frame.Pixels.data();
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            const unsigned char* p = pixels + ((size_t) y * width + x) * 4;
+            luma[(size_t) y * width + x] = (unsigned char) ((77 * p[0] + 150 * p[1] + 29 * p[2] + 128) >> 8);
+        }
+    }
+    for (int y = 0; y < chromaHeight; y++)
+    {
+        for (int x = 0; x < chromaWidth; x++)
+        {
+            int r = 0, g = 0, b = 0;
+            for (int dy = 0; dy < 2; dy++)
+            {
+                for (int dx = 0; dx < 2; dx++)
+                {
+                    int sx = std::min(2 * x + dx, width - 1), sy = std::min(2 * y + dy, height - 1);
+                    const unsigned char* p = pixels + ((size_t) sy * width + sx) * 4;
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                }
+            }
+            // Sums of four pixels, hence the extra >> 2
+            cb[(size_t) y * chromaWidth + x] = (unsigned char) std::clamp((-43 * r - 85 * g + 128 * b + 512) / 1024 + 128, 0, 255);
+            cr[(size_t) y * chromaWidth + x] = (unsigned char) std::clamp((128 * r - 107 * g - 21 * b + 512) / 1024 + 128, 0, 255);
+        }
+    }
+
+    // Frames are encoded in parallel but written in the order they were captured
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_FrameDone.wait(lock, [&]() { return m_WriteSequence == frame.Sequence; });
+    }
+
+    bool written = false;
+    if (!m_WriteFailed)
+    {
+        if (m_StreamWidth == 0)
+        {
+            m_StreamWidth = width;
+            m_StreamHeight = height;
+            std::fprintf(m_Stream, "YUV4MPEG2 W%d H%d F%u:1 Ip A1:1 C420jpeg\n", width, height, m_FramesPerSecond);
+        }
+
+        // The stream cannot change size; frames from a resized window are left out
+        if (width == m_StreamWidth && height == m_StreamHeight)
+        {
+            written = std::fputs("FRAME\n", m_Stream) >= 0
+                && std::fwrite(planes.data(), 1, planes.size(), m_Stream) == planes.size();
+            if (!written)
+            {
+                std::cerr << "Capture: failed to write to " << m_Path << std::endl;
+                m_WriteFailed = true;
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_WriteSequence++;
+    }
+    m_FrameDone.notify_all();
+    return written;
+}
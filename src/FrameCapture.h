@@ -0,0 +1,116 @@
+#pragma once
+
+#include <Debugger.h>
+#include <Framebuffer.h>
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class CaptureFormat
+{
+    PNG, // One file per frame
+    Raw, // One file per frame: width * height RGBA pixels, top row first, no header
+    Y4M  // A single YUV 4:2:0 stream into a file, a named pipe or a command's standard input
+};
+
+struct CaptureStats
+{
+    unsigned int Frames = 0;  // Frames offered to Capture
+    unsigned int Written = 0; // Frames encoded and written
+    unsigned int Dropped = 0; // Frames skipped because the GPU or the writers fell behind
+};
+
+// Records the scene target every frame without stalling the render loop. Each frame is copied
+// into one of two pixel buffer objects behind a fence; once the fence has signaled (usually a
+// frame later) the pixels are copied out and handed to a pool of writer threads that encode and
+// write them. Frames that would have to wait, for a busy buffer or for the writers, are dropped
+// and counted instead.
+//
+// The output path picks the format: "|command" streams Y4M into the command's standard input
+// (e.g. "|ffmpeg -i - replay.mp4"), ".y4m" writes the stream to a file or named pipe, and ".raw"
+// or ".png" write one file per frame, numbered before the extension ("frame.png" becomes
+// "frame_000042.png"). Frame numbers count dropped frames too, so gaps show where they were.
+class FrameCapture
+{
+    private:
+        struct Frame
+        {
+            std::vector<unsigned char> Pixels; // RGBA, top row first
+            int Width = 0, Height = 0;
+            unsigned int Index = 0;            // Frame number, counting dropped frames too
+            unsigned int Sequence = 0;         // Order of the stream writes
+        };
+
+        struct Slot
+        {
+            unsigned int Buffer = 0;
+            unsigned int Size = 0;
+            GLsync Fence = nullptr;
+            int Width = 0, Height = 0;
+            unsigned int Index = 0;
+        };
+
+        static const int SLOT_COUNT = 2;
+
+        CaptureFormat m_Format;
+        std::string m_Path;
+        std::FILE* m_Stream;
+        bool m_IsPipe;
+        unsigned int m_FramesPerSecond;
+        int m_StreamWidth, m_StreamHeight;
+
+        Slot m_Slots[SLOT_COUNT];
+        int m_NextSlot;
+
+        std::vector<std::thread> m_Workers;
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        std::condition_variable m_FrameDone;
+        std::deque<Frame*> m_Queue;
+        std::vector<Frame*> m_FreeFrames;
+        unsigned int m_FrameCount;     // Frames allocated, at most m_MaxFrames
+        unsigned int m_MaxFrames;
+        unsigned int m_NextSequence;   // Given to the next queued frame
+        unsigned int m_WriteSequence;  // Frame allowed to write to the stream next
+        bool m_Stopping;
+        bool m_WriteFailed;
+        CaptureStats m_Stats;
+
+        // Hands the frames whose fences have signaled to the writers, oldest first. With 'wait'
+        // set it blocks on the GPU and on free frames instead of dropping anything.
+        void Collect(bool wait);
+
+        void WorkerLoop();
+        bool Write(const Frame& frame);
+        bool WriteStream(const Frame& frame, std::vector<unsigned char>& planes);
+        std::string GetFramePath(unsigned int index) const;
+    public:
+        // 'threadCount' writer threads; 0 uses half the hardware threads. 'framesPerSecond' only
+        // goes into the Y4M header.
+        FrameCapture(const std::string& path, unsigned int threadCount = 0, unsigned int framesPerSecond = 60);
+        // Flushes and closes the output; needs the GL context.
+        ~FrameCapture();
+
+        FrameCapture(const FrameCapture&) = delete;
+        FrameCapture& operator=(const FrameCapture&) = delete;
+
+        // False if the output stream could not be opened.
+        inline bool IsValid() const { return m_Format != CaptureFormat::Y4M || m_Stream; }
+
+        // Starts the copy of 'source' for this frame and passes on earlier copies that have
+        // finished. Call once per frame after the scene has been drawn.
+        void Capture(const Framebuffer& source);
+
+        // Waits until every frame captured so far has been written. Blocks the render thread;
+        // meant for the end of a run.
+        void Flush();
+
+        CaptureStats GetStats();
+
+        static CaptureFormat GetFormat(const std::string& path);
+};
@@ -0,0 +1,94 @@
+#include <FramePipeline.h>
+#include <RenderState.h>
+
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+// Seconds on a monotonic clock; only differences and the offset from m_StartTime are used.
+static double GetSeconds()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+FramePipeline::FramePipeline()
+    : m_ClearColor(1.0f, 1.0f, 1.0f, 1.0f), m_PresentSource(nullptr), m_Frame(),
+      m_FrameUniforms(sizeof(FrameConstants)), m_StartTime(GetSeconds()), m_LastTime(m_StartTime)
+{
+    m_Frame.View = glm::mat4(1.0f);
+    m_Frame.Projection = glm::mat4(1.0f);
+}
+
+void FramePipeline::SetCamera(const glm::mat4& view, const glm::mat4& projection)
+{
+    m_Frame.View = view;
+    m_Frame.Projection = projection;
+}
+
+void FramePipeline::SetPass(FramePass pass, std::function<void()> draw, Framebuffer* target)
+{
+    m_Passes[(int) pass].Draw = draw;
+    m_Passes[(int) pass].Target = target;
+}
+
+void FramePipeline::SetPassEnabled(FramePass pass, bool enabled)
+{
+    m_Passes[(int) pass].Enabled = enabled;
+}
+
+void FramePipeline::Execute(GLFWwindow* window, int width, int height)
+{
+    Render(width, height);
+
+    if (m_PresentSource)
+        m_PresentSource->BlitToScreen(width, height);
+
+    RenderState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+    glfwSwapBuffers(window);
+}
+
+void FramePipeline::Render(int width, int height)
+{
+    double now = GetSeconds();
+    m_Frame.ViewProjection = m_Frame.Projection * m_Frame.View;
+    m_Frame.Viewport = glm::vec4(width, height, 1.0f / std::max(width, 1), 1.0f / std::max(height, 1));
+    m_Frame.Time = (float) (now - m_StartTime);
+    m_Frame.DeltaTime = (float) (now - m_LastTime);
+    m_LastTime = now;
+    m_FrameUniforms.Update(&m_Frame, sizeof(m_Frame));
+    m_FrameUniforms.Bind(UniformBlock::Frame);
+    m_Frame.FrameIndex++;
+
+    // Every target is cleared right before the first pass that draws into it. The window
+    // needs no clear at all when the present source covers it.
+    std::vector<Framebuffer*> clearedTargets;
+    bool windowCleared = false;
+    for (const Pass& pass : m_Passes)
+    {
+        if (!pass.Enabled || !pass.Draw)
+            continue;
+
+        if (pass.Target)
+        {
+            pass.Target->Bind();
+            if (std::find(clearedTargets.begin(), clearedTargets.end(), pass.Target) == clearedTargets.end())
+            {
+                pass.Target->Clear(m_ClearColor);
+                clearedTargets.push_back(pass.Target);
+            }
+        }
+        else
+        {
+            RenderState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+            GLCall(glViewport(0, 0, width, height));
+            if (!windowCleared)
+            {
+                GLCall(glClearColor(m_ClearColor.r, m_ClearColor.g, m_ClearColor.b, m_ClearColor.a));
+                GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+                windowCleared = true;
+            }
+        }
+
+        pass.Draw();
+    }
+}
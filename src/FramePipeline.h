@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Framebuffer.h>
+#include <UniformBuffer.h>
+
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include <functional>
+
+// Passes run in declaration order every frame.
+enum class FramePass
+{
+    Scene = 0, // The visible cube, also writing object IDs for picking
+    Overlay,   // Selection outline and anything else drawn on top of the scene
+    Count
+};
+
+// Per-frame constants, laid out as the std140 "Frame" uniform block that every shader shares.
+struct FrameConstants
+{
+    glm::mat4 View;
+    glm::mat4 Projection;
+    glm::mat4 ViewProjection;
+    glm::vec4 Viewport;      // Width, height, 1 / width, 1 / height in pixels
+    float Time;              // Seconds since the pipeline was created
+    float DeltaTime;         // Seconds since the previous frame
+    unsigned int FrameIndex;
+    float Padding;
+};
+static_assert(sizeof(FrameConstants) == 224, "FrameConstants must match the std140 Frame block");
+
+// Owns the per-frame sequence: every render target is cleared exactly once, the enabled
+// passes run in order, and the frame is presented once at the end. When a present source
+// is set, its color is copied to the window right before presenting. Before the first pass the
+// frame constants are uploaded once and bound to UniformBlock::Frame.
+class FramePipeline
+{
+    private:
+        struct Pass
+        {
+            std::function<void()> Draw;
+            Framebuffer* Target = nullptr; // nullptr draws to the window
+            bool Enabled = true;
+        };
+
+        Pass m_Passes[(int) FramePass::Count];
+        glm::vec4 m_ClearColor;
+        Framebuffer* m_PresentSource;
+        FrameConstants m_Frame;
+        UniformBuffer m_FrameUniforms;
+        double m_StartTime;
+        double m_LastTime;
+    public:
+        FramePipeline();
+
+        void SetPass(FramePass pass, std::function<void()> draw, Framebuffer* target = nullptr);
+        void SetPassEnabled(FramePass pass, bool enabled);
+        inline void SetClearColor(const glm::vec4& color) { m_ClearColor = color; }
+        inline void SetPresentSource(Framebuffer* source) { m_PresentSource = source; }
+
+        // Camera for the next Execute(); the view-projection product is formed there, once.
+        void SetCamera(const glm::mat4& view, const glm::mat4& projection);
+
+        // Runs the passes and presents to 'window', whose framebuffer is 'width' x 'height'. The
+        // size comes from the caller, as GLFW only reports it on the main thread.
+        void Execute(GLFWwindow* window, int width, int height);
+        // Runs the passes for a 'width' x 'height' frame without presenting it, for headless
+        // rendering where every pass draws into a Framebuffer.
+        void Render(int width, int height);
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// Copy of the cube taken after a simulation tick (see RubiksCube::snapshot), everything the
+// CubeRenderer draws. Cube i is drawn at Rotations[i] * Models[i]; the cubes of the layer being
+// turned are also turned about TurnAxis through Center, by an angle between PreviousTurnAngle
+// (the tick before) and TurnAngle (this tick).
+struct CubeSnapshot
+{
+    std::vector<glm::mat4> Models;
+    std::vector<glm::mat4> Rotations;
+    std::vector<glm::ivec3> Slots;      // Home slots, which select the cubes' mesh ranges
+    std::vector<unsigned char> Turning; // 1 for the cubes of the layer being turned
+    std::vector<unsigned char> Stickers;
+    glm::vec3 Center = glm::vec3(0.0f);
+    int TurnAxis = 0;
+    float PreviousTurnAngle = 0.0f;
+    float TurnAngle = 0.0f;
+    bool HalfTurned = false; // A wall is stuck part way through a turn
+    int Selected = -1;       // Index of the selected cube, -1 for none
+};
+
+// Everything a frame is rendered from. The simulation thread publishes one after every tick
+// through a TripleBuffer, and the render thread draws the newest one it has acquired, so neither
+// ever waits for the other and the renderer never reads the live simulation objects.
+struct FrameSnapshot
+{
+    CubeSnapshot Cube;
+    glm::mat4 View = glm::mat4(1.0f);
+    glm::mat4 Projection = glm::mat4(1.0f);
+    int ViewportWidth = 0, ViewportHeight = 0; // The camera's, in screen coordinates
+    int FramebufferWidth = 0, FramebufferHeight = 0;
+    bool GPUPicking = false;
+    unsigned int ScreenshotRequests = 0; // F12 presses so far
+
+    unsigned long long Tick = 0; // Ticks simulated so far
+    double TickTime = 0.0;       // When the latest tick was due, in glfwGetTime() seconds
+    float TickLength = 0.0f;
+};
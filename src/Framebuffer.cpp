@@ -0,0 +1,143 @@
+#include <Framebuffer.h>
+#include <RenderState.h>
+
+Framebuffer::Framebuffer(int width, int height, bool withObjectIDs)
+    : m_RendererID(0), m_ColorAttachment(0), m_ObjectIDAttachment(0), m_DepthAttachment(0),
+      m_Width(width), m_Height(height), m_HasObjectIDs(withObjectIDs)
+{
+    Create();
+}
+
+Framebuffer::~Framebuffer()
+{
+    Destroy();
+}
+
+void Framebuffer::Create()
+{
+    GLCall(glGenFramebuffers(1, &m_RendererID));
+    RenderState::BindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
+
+    GLCall(glGenRenderbuffers(1, &m_ColorAttachment));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_ColorAttachment));
+    GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_Width, m_Height));
+    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorAttachment));
+
+    if (m_HasObjectIDs)
+    {
+        GLCall(glGenRenderbuffers(1, &m_ObjectIDAttachment));
+        GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_ObjectIDAttachment));
+        GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_R32UI, m_Width, m_Height));
+        GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_RENDERBUFFER, m_ObjectIDAttachment));
+
+        const GLenum drawBuffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+        GLCall(glDrawBuffers(2, drawBuffers));
+    }
+
+    GLCall(glGenRenderbuffers(1, &m_DepthAttachment));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_DepthAttachment));
+    GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_Width, m_Height));
+    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_DepthAttachment));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+
+    GLCall(GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "Framebuffer is incomplete (" << status << ")" << std::endl;
+
+    RenderState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Framebuffer::Destroy()
+{
+    RenderState::DeleteFramebuffer(m_RendererID);
+    GLCall(glDeleteRenderbuffers(1, &m_ColorAttachment));
+    if (m_HasObjectIDs)
+    {
+        GLCall(glDeleteRenderbuffers(1, &m_ObjectIDAttachment));
+    }
+    GLCall(glDeleteRenderbuffers(1, &m_DepthAttachment));
+}
+
+void Framebuffer::Resize(int width, int height)
+{
+    if (width == m_Width && height == m_Height)
+        return;
+
+    Destroy();
+    m_Width = width;
+    m_Height = height;
+    Create();
+}
+
+void Framebuffer::Bind() const
+{
+    RenderState::BindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
+    GLCall(glViewport(0, 0, m_Width, m_Height));
+}
+
+void Framebuffer::Unbind() const
+{
+    RenderState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Framebuffer::Clear(const glm::vec4& color) const
+{
+    GLCall(glClearBufferfv(GL_COLOR, 0, &color[0]));
+    if (m_HasObjectIDs)
+    {
+        const GLuint noObject[4] = { 0, 0, 0, 0 };
+        GLCall(glClearBufferuiv(GL_COLOR, 1, noObject));
+    }
+    const GLfloat farDepth = 1.0f;
+    GLCall(glClearBufferfv(GL_DEPTH, 0, &farDepth));
+}
+
+void Framebuffer::BlitToScreen(int width, int height) const
+{
+    RenderState::BindFramebuffer(GL_READ_FRAMEBUFFER, m_RendererID);
+    RenderState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    GLCall(glReadBuffer(GL_COLOR_ATTACHMENT0));
+    GLCall(glBlitFramebuffer(0, 0, m_Width, m_Height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST));
+}
+
+void Framebuffer::ReadPixels(unsigned char* pixels) const
+{
+    RenderState::BindFramebuffer(GL_READ_FRAMEBUFFER, m_RendererID);
+    GLCall(glReadBuffer(GL_COLOR_ATTACHMENT0));
+    RenderState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    GLCall(glReadPixels(0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+}
+
+void Framebuffer::ReadPixels(int x, int y, int width, int height, unsigned char* rgb, int rowLength) const
+{
+    RenderState::BindFramebuffer(GL_READ_FRAMEBUFFER, m_RendererID);
+    GLCall(glReadBuffer(GL_COLOR_ATTACHMENT0));
+    RenderState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    GLCall(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+    GLCall(glPixelStorei(GL_PACK_ROW_LENGTH, rowLength));
+    GLCall(glReadPixels(x, y, width, height, GL_RGB, GL_UNSIGNED_BYTE, rgb));
+    GLCall(glPixelStorei(GL_PACK_ROW_LENGTH, 0));
+    GLCall(glPixelStorei(GL_PACK_ALIGNMENT, 4));
+}
+
+void Framebuffer::ReadPixelsAsync() const
+{
+    RenderState::BindFramebuffer(GL_READ_FRAMEBUFFER, m_RendererID);
+    GLCall(glReadBuffer(GL_COLOR_ATTACHMENT0));
+    GLCall(glReadPixels(0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+}
+
+void Framebuffer::ReadObjectIDAsync(int x, int y) const
+{
+    if (!m_HasObjectIDs || x < 0 || y < 0 || x >= m_Width || y >= m_Height)
+    {
+        // Leave the background ID in the pack buffer
+        const GLuint noObject = 0;
+        GLCall(glBufferSubData(GL_PIXEL_PACK_BUFFER, 0, sizeof(noObject), &noObject));
+        return;
+    }
+
+    RenderState::BindFramebuffer(GL_READ_FRAMEBUFFER, m_RendererID);
+    GLCall(glReadBuffer(GL_COLOR_ATTACHMENT1));
+    GLCall(glReadPixels(x, y, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr));
+}
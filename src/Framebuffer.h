@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Debugger.h>
+
+#include <glm/glm.hpp>
+
+// FBO with an RGBA8 color and a 24-bit depth attachment, used for offscreen passes.
+// With object IDs enabled, color attachment 1 is an R32UI buffer that shaders write the
+// picking ID of each fragment into (0 means nothing was drawn there).
+class Framebuffer
+{
+    private:
+        unsigned int m_RendererID;
+        unsigned int m_ColorAttachment;
+        unsigned int m_ObjectIDAttachment;
+        unsigned int m_DepthAttachment;
+        int m_Width, m_Height;
+        bool m_HasObjectIDs;
+
+        void Create();
+        void Destroy();
+    public:
+        Framebuffer(int width, int height, bool withObjectIDs = false);
+        ~Framebuffer();
+
+        // Recreates the attachments; does nothing when the size is unchanged.
+        void Resize(int width, int height);
+
+        void Bind() const;
+        void Unbind() const;
+
+        // Clears color to 'color', depth to 1 and object IDs to 0. The framebuffer must be bound.
+        void Clear(const glm::vec4& color) const;
+
+        // Copies the color attachment into the window's back buffer.
+        void BlitToScreen(int width, int height) const;
+
+        // Reads a region of the color attachment as RGB, bottom row first, with rows 'rowLength'
+        // pixels apart in 'rgb'. Waits for the GPU to finish the frame.
+        void ReadPixels(int x, int y, int width, int height, unsigned char* rgb, int rowLength) const;
+        // Reads the whole color attachment as RGBA, bottom row first, into 'pixels', which must
+        // hold width * height * 4 bytes. Waits for the GPU to finish the frame.
+        void ReadPixels(unsigned char* pixels) const;
+        // Copies the whole color attachment (RGBA, bottom row first) into the bound
+        // GL_PIXEL_PACK_BUFFER at offset 0, without waiting for the GPU.
+        void ReadPixelsAsync() const;
+        // Copies one object ID (origin at the bottom-left corner) into the bound GL_PIXEL_PACK_BUFFER
+        // at offset 0, without waiting for the GPU. Writes 0 when there are no object IDs.
+        void ReadObjectIDAsync(int x, int y) const;
+
+        inline int GetWidth() const { return m_Width; }
+        inline int GetHeight() const { return m_Height; }
+        inline bool HasObjectIDs() const { return m_HasObjectIDs; }
+};
@@ -0,0 +1,46 @@
+#include <GLExtensions.h>
+
+#include <cstring>
+
+GLExtensions GLExt;
+
+bool GLHasExtension(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++)
+    {
+        const char* extension = (const char*) glGetStringi(GL_EXTENSIONS, i);
+        if (extension && std::strcmp(extension, name) == 0)
+            return true;
+    }
+    return false;
+}
+
+void GLLoadExtensions(GLADloadproc load)
+{
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    bool gl41 = major > 4 || (major == 4 && minor >= 1);
+    bool gl43 = major > 4 || (major == 4 && minor >= 3);
+
+    // KHR_debug is core since 4.3, and in a core profile the extension uses unsuffixed names too
+    if (gl43 || GLHasExtension("GL_KHR_debug"))
+    {
+        GLExt.DebugMessageCallback = (PFNGLDEBUGMESSAGECALLBACKPROC) load("glDebugMessageCallback");
+        GLExt.KHR_debug = GLExt.DebugMessageCallback != nullptr;
+    }
+
+    if (gl41 || GLHasExtension("GL_ARB_get_program_binary"))
+    {
+        GLExt.GetProgramBinary = (PFNGLGETPROGRAMBINARYPROC) load("glGetProgramBinary");
+        GLExt.ProgramBinary = (PFNGLPROGRAMBINARYPROC) load("glProgramBinary");
+        GLExt.ProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC) load("glProgramParameteri");
+
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        GLExt.ARB_get_program_binary = GLExt.GetProgramBinary && GLExt.ProgramBinary
+            && GLExt.ProgramParameteri && formats > 0;
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// glad only covers core GL 3.3; entry points from newer versions and extensions are loaded here.
+#define GL_DEBUG_OUTPUT                   0x92E0
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS       0x8242
+#define GL_DEBUG_SOURCE_SHADER_COMPILER   0x8248
+#define GL_DEBUG_TYPE_ERROR               0x824C
+#define GL_DEBUG_SEVERITY_HIGH            0x9146
+#define GL_DEBUG_SEVERITY_MEDIUM          0x9147
+#define GL_DEBUG_SEVERITY_LOW             0x9148
+#define GL_DEBUG_SEVERITY_NOTIFICATION    0x826B
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH          0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS     0x87FE
+#define GL_PROGRAM_BINARY_FORMATS         0x87FF
+
+typedef void (APIENTRYP PFNGLDEBUGMESSAGECALLBACKPROC)(GLDEBUGPROC callback, const void* userParam);
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFNGLPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+
+struct GLExtensions
+{
+    bool KHR_debug = false;
+    // Also requires the driver to offer at least one binary format
+    bool ARB_get_program_binary = false;
+
+    PFNGLDEBUGMESSAGECALLBACKPROC DebugMessageCallback = nullptr;
+    PFNGLGETPROGRAMBINARYPROC GetProgramBinary = nullptr;
+    PFNGLPROGRAMBINARYPROC ProgramBinary = nullptr;
+    PFNGLPROGRAMPARAMETERIPROC ProgramParameteri = nullptr;
+};
+
+// Filled by GLLoadExtensions(); entry points stay null when the context lacks the extension.
+extern GLExtensions GLExt;
+
+// Must run after gladLoadGL() with the context current. 'load' is the window system's
+// proc address lookup (e.g. glfwGetProcAddress).
+void GLLoadExtensions(GLADloadproc load);
+bool GLHasExtension(const char* name);
@@ -0,0 +1,124 @@
+#include <HeadlessContext.h>
+
+#include <iostream>
+
+#ifdef __linux__
+
+// The headless build needs no X11 headers
+#define EGL_NO_X11
+#define MESA_EGL_NO_X11_HEADERS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cstring>
+
+// Whether the space separated extension list 'extensions' holds 'name'.
+static bool HasExtension(const char* extensions, const char* name)
+{
+    if (!extensions)
+        return false;
+    size_t length = std::strlen(name);
+    for (const char* start = extensions; (start = std::strstr(start, name)); start += length)
+    {
+        bool startsWord = start == extensions || start[-1] == ' ';
+        if (startsWord && (start[length] == ' ' || start[length] == '\0'))
+            return true;
+    }
+    return false;
+}
+
+HeadlessContext::HeadlessContext()
+    : m_Display(nullptr), m_Context(nullptr)
+{
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (!getPlatformDisplay || !HasExtension(clientExtensions, "EGL_MESA_platform_surfaceless"))
+    {
+        std::cerr << "Headless: EGL_MESA_platform_surfaceless is not supported." << std::endl;
+        return;
+    }
+
+    EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    EGLint major, minor;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+    {
+        std::cerr << "Headless: failed to initialize the EGL display (0x" << std::hex << eglGetError() << std::dec << ")." << std::endl;
+        return;
+    }
+    m_Display = display;
+
+    // Without a surface the context needs no config, but the display must allow that
+    if (!HasExtension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context")
+        || !eglBindAPI(EGL_OPENGL_API))
+    {
+        std::cerr << "Headless: surfaceless desktop OpenGL contexts are not supported." << std::endl;
+        return;
+    }
+
+    EGLint attributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+#ifndef NDEBUG
+        EGL_CONTEXT_OPENGL_DEBUG, EGL_TRUE, // Debug builds report GL errors via KHR_debug
+#endif
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+#ifndef NDEBUG
+    if (context == EGL_NO_CONTEXT)
+    {
+        // Retry without the debug flag, which EGL 1.4 does not know; glGetError still works
+        attributes[6] = EGL_NONE;
+        context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+    }
+#endif
+    if (context == EGL_NO_CONTEXT)
+    {
+        std::cerr << "Headless: failed to create an OpenGL 3.3 core context (0x" << std::hex << eglGetError() << std::dec << ")." << std::endl;
+        return;
+    }
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+    {
+        std::cerr << "Headless: failed to make the context current (0x" << std::hex << eglGetError() << std::dec << ")." << std::endl;
+        eglDestroyContext(display, context);
+        return;
+    }
+    m_Context = context;
+}
+
+HeadlessContext::~HeadlessContext()
+{
+    if (!m_Display)
+        return;
+    if (m_Context)
+    {
+        eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(m_Display, m_Context);
+    }
+    eglTerminate(m_Display);
+}
+
+void* HeadlessContext::GetProcAddress(const char* name)
+{
+    return (void*) eglGetProcAddress(name);
+}
+
+#else
+
+HeadlessContext::HeadlessContext()
+    : m_Display(nullptr), m_Context(nullptr)
+{
+    std::cerr << "Headless: only supported on Linux (EGL)." << std::endl;
+}
+
+HeadlessContext::~HeadlessContext()
+{
+}
+
+void* HeadlessContext::GetProcAddress(const char* name)
+{
+    return nullptr;
+}
+
+#endif
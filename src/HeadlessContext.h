@@ -0,0 +1,26 @@
+#pragma once
+
+// GL 3.3 core context without a window or a display server, for batch renders and benchmarks on
+// servers. It is created through EGL on Mesa's surfaceless platform (EGL_MESA_platform_surfaceless),
+// which runs on the GPU's render node or falls back to llvmpipe. There is no default framebuffer:
+// everything must be drawn into Framebuffers. Only available on Linux; elsewhere IsValid() is
+// always false.
+class HeadlessContext
+{
+    private:
+        void* m_Display;
+        void* m_Context;
+    public:
+        // Creates the context and makes it current on the calling thread. Reports the reason to
+        // std::cerr when that fails.
+        HeadlessContext();
+        ~HeadlessContext();
+
+        HeadlessContext(const HeadlessContext&) = delete;
+        HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+        inline bool IsValid() const { return m_Context != nullptr; }
+
+        // GL entry point lookup for gladLoadGLLoader and GLLoadExtensions.
+        static void* GetProcAddress(const char* name);
+};
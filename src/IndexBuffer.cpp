@@ -1,26 +1,37 @@
 #include <IndexBuffer.h>
+#include <RenderState.h>
 
 IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int size)
-    : m_Count(size / sizeof(unsigned int))
+    : m_Count(size / sizeof(unsigned int)), m_Type(GL_UNSIGNED_INT)
 {
     ASSERT(sizeof(unsigned int) == sizeof(GLuint));
 
     GLCall(glGenBuffers(1, &m_RendererID));
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+    RenderState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
+}
+
+IndexBuffer::IndexBuffer(const unsigned short* data, unsigned int size)
+    : m_Count(size / sizeof(unsigned short)), m_Type(GL_UNSIGNED_SHORT)
+{
+    ASSERT(sizeof(unsigned short) == sizeof(GLushort));
+
+    GLCall(glGenBuffers(1, &m_RendererID));
+    RenderState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
     GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
 }
 
 IndexBuffer::~IndexBuffer()
 {
-    GLCall(glDeleteBuffers(1, &m_RendererID));
+    RenderState::DeleteBuffer(m_RendererID);
 }
 
 void IndexBuffer::Bind() const
 {
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+    RenderState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
 }
 
 void IndexBuffer::Unbind() const
 {
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+    RenderState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
\ No newline at end of file
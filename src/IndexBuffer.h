@@ -8,12 +8,18 @@ class IndexBuffer
     private:
         unsigned int m_RendererID;
         unsigned int m_Count;
+        unsigned int m_Type;
     public:
+        // 'size' is in bytes. 16-bit indices halve the buffer; use them whenever every index fits.
         IndexBuffer(const unsigned int* data, unsigned int size);
+        IndexBuffer(const unsigned short* data, unsigned int size);
         ~IndexBuffer();
 
         void Bind() const;
         void Unbind() const;
 
         inline unsigned int GetCount() const { return m_Count; }
+        // GL_UNSIGNED_INT or GL_UNSIGNED_SHORT, as passed to glDrawElements
+        inline unsigned int GetType() const { return m_Type; }
+        inline unsigned int GetIndexSize() const { return m_Type == GL_UNSIGNED_SHORT ? 2 : 4; }
 };
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include <PNGStreamWriter.h>
+
+#include <iostream>
+
+// Compressed bytes collected before they are written out as one IDAT chunk
+static const size_t CHUNK_SIZE = 1 << 16;
+
+// Deflate match lengths: the base length of each length symbol (257 on) and its extra bits
+static const unsigned int LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const int LENGTH_EXTRA_BITS[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+static uint32_t UpdateCRC(uint32_t crc, const unsigned char* data, size_t size)
+{
+    static uint32_t table[256] = {};
+    if (!table[1])
+    {
+        for (uint32_t n = 0; n < 256; n++)
+        {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++)
+                c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+    }
+    for (size_t i = 0; i < size; i++)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+static void PutBigEndian(unsigned char* out, uint32_t value)
+{
+    out[0] = (unsigned char) (value >> 24);
+    out[1] = (unsigned char) (value >> 16);
+    out[2] = (unsigned char) (value >> 8);
+    out[3] = (unsigned char) value;
+}
+
+PNGStreamWriter::PNGStreamWriter(const std::string& filepath, int width, int height)
+    : m_File(std::fopen(filepath.c_str(), "wb")), m_Width(width), m_Height(height), m_RowsWritten(0),
+      m_Failed(false), m_BitBuffer(0), m_BitCount(0), m_LastByte(-1), m_Run(0), m_Adler1(1), m_Adler2(0)
+{
+    if (!m_File)
+    {
+        std::cerr << "Failed to open " << filepath << std::endl;
+        return;
+    }
+
+    static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    m_Failed = std::fwrite(signature, 1, sizeof(signature), m_File) != sizeof(signature);
+
+    // 8-bit RGB, deflate, adaptive filtering, not interlaced
+    unsigned char header[13];
+    PutBigEndian(header, (uint32_t) width);
+    PutBigEndian(header + 4, (uint32_t) height);
+    header[8] = 8;
+    header[9] = 2;
+    header[10] = 0;
+    header[11] = 0;
+    header[12] = 0;
+    WriteChunk("IHDR", header, sizeof(header));
+
+    // zlib header (deflate with a 32 KiB window, fastest level), then a fixed Huffman block that
+    // stays open until Close
+    m_Chunk.reserve(CHUNK_SIZE + 64);
+    m_Chunk.push_back(0x78);
+    m_Chunk.push_back(0x01);
+    WriteBits(0, 1);
+    WriteBits(1, 2);
+
+    m_Row.resize(1 + (size_t) width * 3);
+    m_Row[0] = 1; // Sub filter
+}
+
+PNGStreamWriter::~PNGStreamWriter()
+{
+    if (m_File)
+        std::fclose(m_File);
+}
+
+void PNGStreamWriter::WriteChunk(const char type[4], const unsigned char* data, size_t size)
+{
+    unsigned char length[4], crc[4];
+    PutBigEndian(length, (uint32_t) size);
+    uint32_t checksum = UpdateCRC(0xFFFFFFFFu, (const unsigned char*) type, 4);
+    checksum = UpdateCRC(checksum, data, size);
+    PutBigEndian(crc, checksum ^ 0xFFFFFFFFu);
+
+    bool written = std::fwrite(length, 1, 4, m_File) == 4 && std::fwrite(type, 1, 4, m_File) == 4
+        && std::fwrite(data, 1, size, m_File) == size && std::fwrite(crc, 1, 4, m_File) == 4;
+    if (!written)
+        m_Failed = true;
+}
+
+void PNGStreamWriter::WriteBits(uint32_t bits, int count)
+{
+    m_BitBuffer |= bits << m_BitCount;
+    m_BitCount += count;
+    while (m_BitCount >= 8)
+    {
+        m_Chunk.push_back((unsigned char) m_BitBuffer);
+        m_BitBuffer >>= 8;
+        m_BitCount -= 8;
+    }
+}
+
+// Huffman codes go into the bit stream starting with their most significant bit.
+void PNGStreamWriter::WriteSymbol(unsigned int symbol)
+{
+    uint32_t code;
+    int length;
+    if (symbol < 144)
+    {
+        code = 0x30 + symbol;
+        length = 8;
+    }
+    else if (symbol < 256)
+    {
+        code = 0x190 + symbol - 144;
+        length = 9;
+    }
+    else if (symbol < 280)
+    {
+        code = symbol - 256;
+        length = 7;
+    }
+    else
+    {
+        code = 0xC0 + symbol - 280;
+        length = 8;
+    }
+
+    uint32_t reversed = 0;
+    for (int i = 0; i < length; i++)
+        reversed |= ((code >> i) & 1) << (length - 1 - i);
+    WriteBits(reversed, length);
+}
+
+void PNGStreamWriter::FlushRun()
+{
+    if (m_Run >= 3)
+    {
+        int symbol = 28;
+        while (LENGTH_BASE[symbol] > m_Run)
+            symbol--;
+        WriteSymbol(257 + symbol);
+        WriteBits(m_Run - LENGTH_BASE[symbol], LENGTH_EXTRA_BITS[symbol]);
+        WriteBits(0, 5); // Distance code 0: one byte back
+    }
+    else
+    {
+        for (unsigned int i = 0; i < m_Run; i++)
+            WriteSymbol(m_LastByte);
+    }
+    m_Run = 0;
+}
+
+void PNGStreamWriter::WriteByte(unsigned char value)
+{
+    m_Adler1 = (m_Adler1 + value) % 65521;
+    m_Adler2 = (m_Adler2 + m_Adler1) % 65521;
+
+    if (value == m_LastByte)
+    {
+        if (++m_Run == 258)
+            FlushRun();
+        return;
+    }
+    FlushRun();
+    WriteSymbol(value);
+    m_LastByte = value;
+}
+
+void PNGStreamWriter::FlushChunk(bool force)
+{
+    if (m_Chunk.size() >= CHUNK_SIZE || (force && !m_Chunk.empty()))
+    {
+        WriteChunk("IDAT", m_Chunk.data(), m_Chunk.size());
+        m_Chunk.clear();
+    }
+}
+
+void PNGStreamWriter::WriteRows(const unsigned char* rgb, int count, size_t stride)
+{
+    if (!IsValid())
+        return;
+
+    size_t rowSize = (size_t) m_Width * 3;
+    for (int y = 0; y < count && m_RowsWritten < m_Height; y++, m_RowsWritten++)
+    {
+        // Sub filter: each byte minus the same channel of the pixel on its left
+        const unsigned char* row = rgb + y * stride;
+        for (size_t i = 0; i < rowSize; i++)
+            m_Row[1 + i] = (unsigned char) (row[i] - (i >= 3 ? row[i - 3] : 0));
+
+        for (unsigned char value : m_Row)
+        {
+            WriteByte(value);
+            // Adds at most a few bytes past CHUNK_SIZE
+            if (m_Chunk.size() >= CHUNK_SIZE)
+                FlushChunk(false);
+        }
+    }
+}
+
+bool PNGStreamWriter::Close()
+{
+    if (!m_File)
+        return false;
+
+    // End the open block, add an empty final one and pad to a whole byte
+    FlushRun();
+    WriteSymbol(256);
+    WriteBits(1, 1);
+    WriteBits(1, 2);
+    WriteSymbol(256);
+    if (m_BitCount > 0)
+        WriteBits(0, 8 - m_BitCount);
+
+    unsigned char adler[4];
+    PutBigEndian(adler, (m_Adler2 << 16) | m_Adler1);
+    m_Chunk.insert(m_Chunk.end(), adler, adler + 4);
+    FlushChunk(true);
+    WriteChunk("IEND", nullptr, 0);
+
+    bool complete = !m_Failed && m_RowsWritten == m_Height;
+    if (std::fclose(m_File) != 0)
+        complete = false;
+    m_File = nullptr;
+    return complete;
+}
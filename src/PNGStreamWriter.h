@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Writes an 8-bit RGB PNG row by row, top row first, so that images far larger than memory can be
+// produced. Only a few kilobytes are buffered. Rows are Sub filtered and deflated with the fixed
+// Huffman codes, using runs of repeated bytes as the only matches: much weaker than zlib, but it
+// needs no look-back window and shrinks the flat backgrounds and stickers of renders well.
+class PNGStreamWriter
+{
+    private:
+        std::FILE* m_File;
+        int m_Width, m_Height;
+        int m_RowsWritten;
+        bool m_Failed;
+
+        // Deflate state
+        uint32_t m_BitBuffer;
+        int m_BitCount;
+        int m_LastByte;       // -1 before the first byte
+        unsigned int m_Run;   // Repeats of m_LastByte not emitted yet
+        uint32_t m_Adler1, m_Adler2;
+        std::vector<unsigned char> m_Chunk; // Compressed bytes of the next IDAT chunk
+        std::vector<unsigned char> m_Row;   // Filtered row, with the filter type in front
+
+        void WriteChunk(const char type[4], const unsigned char* data, size_t size);
+        void WriteBits(uint32_t bits, int count);
+        void WriteSymbol(unsigned int symbol);
+        void WriteByte(unsigned char value);
+        void FlushRun();
+        void FlushChunk(bool force);
+    public:
+        PNGStreamWriter(const std::string& filepath, int width, int height);
+        ~PNGStreamWriter();
+
+        PNGStreamWriter(const PNGStreamWriter&) = delete;
+        PNGStreamWriter& operator=(const PNGStreamWriter&) = delete;
+
+        // Appends 'count' rows of 'width' RGB pixels, 'stride' bytes apart.
+        void WriteRows(const unsigned char* rgb, int count, size_t stride);
+
+        // Finishes the file; false if any write failed or rows are missing.
+        bool Close();
+
+        inline bool IsValid() const { return m_File && !m_Failed; }
+};
@@ -0,0 +1,92 @@
+#include <PickReadback.h>
+#include <RenderState.h>
+
+PickReadback::PickReadback()
+{
+    for (Slot& slot : m_Slots)
+    {
+        GLCall(glGenBuffers(1, &slot.Buffer));
+        RenderState::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+        GLCall(glBufferData(GL_PIXEL_PACK_BUFFER, sizeof(GLuint), nullptr, GL_STREAM_READ));
+    }
+    RenderState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+PickReadback::~PickReadback()
+{
+    for (Slot& slot : m_Slots)
+    {
+        if (slot.Fence)
+        {
+            GLCall(glDeleteSync(slot.Fence));
+        }
+        RenderState::DeleteBuffer(slot.Buffer);
+    }
+}
+
+void PickReadback::Request(int x, int y, Callback onResult)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Pending.push_back({ x, y, onResult });
+}
+
+void PickReadback::Issue(const Framebuffer& target)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto request = m_Pending.begin();
+    for (Slot& slot : m_Slots)
+    {
+        if (request == m_Pending.end())
+            break;
+        if (slot.Fence)
+            continue;
+
+        // With a pack buffer bound, glReadPixels only schedules the copy
+        RenderState::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+        target.ReadObjectIDAsync(request->X, request->Y);
+        GLCall(slot.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        slot.OnResult = request->OnResult;
+        ++request;
+    }
+    RenderState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    // Requests that found no free slot wait for the next frame
+    m_Pending.erase(m_Pending.begin(), request);
+}
+
+void PickReadback::Poll()
+{
+    for (Slot& slot : m_Slots)
+    {
+        if (!slot.Fence)
+            continue;
+
+        GLint status = GL_UNSIGNALED;
+        GLCall(glGetSynciv(slot.Fence, GL_SYNC_STATUS, 1, nullptr, &status));
+        if (status != GL_SIGNALED)
+            continue;
+
+        GLuint objectID = 0;
+        RenderState::BindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+        GLCall(glGetBufferSubData(GL_PIXEL_PACK_BUFFER, 0, sizeof(objectID), &objectID));
+        RenderState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        GLCall(glDeleteSync(slot.Fence));
+        slot.Fence = nullptr;
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Results.push_back({ objectID, slot.OnResult });
+        slot.OnResult = nullptr;
+    }
+}
+
+void PickReadback::Deliver()
+{
+    std::vector<Result> results;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        results.swap(m_Results);
+    }
+    // Outside the lock, since a callback may queue the next request
+    for (Result& result : results)
+        result.OnResult(result.ObjectID);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Debugger.h>
+#include <Framebuffer.h>
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Asynchronous object ID readback. Requests are only queued by the input callbacks; the render
+// thread copies the pixel into a pixel buffer object behind a fence and collects the result once
+// the GPU has signaled the fence (usually a frame or two later). The input thread then hands it
+// to the request's callback, so the callbacks never run on the render thread. Nothing here ever
+// waits for the GPU.
+class PickReadback
+{
+    public:
+        using Callback = std::function<void(unsigned int objectID)>;
+    private:
+        struct Request
+        {
+            int X, Y;
+            Callback OnResult;
+        };
+
+        struct Slot
+        {
+            unsigned int Buffer = 0;
+            GLsync Fence = nullptr;
+            Callback OnResult;
+        };
+
+        struct Result
+        {
+            unsigned int ObjectID;
+            Callback OnResult;
+        };
+
+        static const int SLOT_COUNT = 3;
+
+        std::mutex m_Mutex;
+        std::vector<Request> m_Pending;
+        std::vector<Result> m_Results;
+        Slot m_Slots[SLOT_COUNT];
+    public:
+        PickReadback();
+        ~PickReadback();
+
+        // Queues a read of the object ID at (x, y), in framebuffer pixels from the bottom-left.
+        void Request(int x, int y, Callback onResult);
+
+        // Starts the copies for queued requests; call after the scene pass has been drawn.
+        void Issue(const Framebuffer& target);
+
+        // Collects every result whose fence has been signaled; render thread.
+        void Poll();
+
+        // Calls the callbacks of the collected results; input thread.
+        void Deliver();
+};
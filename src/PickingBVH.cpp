@@ -0,0 +1,154 @@
+#include <PickingBVH.h>
+#include <CubeState.h>
+
+#include <algorithm>
+#include <limits>
+
+// Slab test; returns the entry distance in 'tNear' when the ray hits [min, max] before maxDistance.
+static bool IntersectAABB(const glm::vec3& min, const glm::vec3& max, const glm::vec3& origin,
+                          const glm::vec3& inverseDirection, float maxDistance, float& tNear, int* axis = nullptr)
+{
+    glm::vec3 t0 = (min - origin) * inverseDirection;
+    glm::vec3 t1 = (max - origin) * inverseDirection;
+    glm::vec3 tSmall = glm::min(t0, t1);
+    glm::vec3 tBig = glm::max(t0, t1);
+
+    tNear = std::max(std::max(tSmall.x, tSmall.y), std::max(tSmall.z, 0.0f));
+    float tFar = std::min(std::min(tBig.x, tBig.y), std::min(tBig.z, maxDistance));
+    if (axis)
+        *axis = (tSmall.x >= tSmall.y && tSmall.x >= tSmall.z) ? 0 : (tSmall.y >= tSmall.z ? 1 : 2);
+    return tNear <= tFar;
+}
+
+void PickingBVH::Build(const std::vector<glm::mat4>& models)
+{
+    m_Boxes.clear();
+    m_Order.clear();
+    m_Nodes.clear();
+    if (models.empty())
+        return;
+
+    for (const glm::mat4& model : models)
+    {
+        Box box;
+        box.Model = model;
+        box.InverseModel = glm::inverse(model);
+        box.Min = glm::vec3(std::numeric_limits<float>::max());
+        box.Max = glm::vec3(-std::numeric_limits<float>::max());
+        for (int corner = 0; corner < 8; corner++)
+        {
+            glm::vec3 local((corner & 1) ? 0.5f : -0.5f, (corner & 2) ? 0.5f : -0.5f, (corner & 4) ? 0.5f : -0.5f);
+            glm::vec3 world = glm::vec3(model * glm::vec4(local, 1.0f));
+            box.Min = glm::min(box.Min, world);
+            box.Max = glm::max(box.Max, world);
+        }
+        box.Center = (box.Min + box.Max) * 0.5f;
+        m_Order.push_back((int) m_Boxes.size());
+        m_Boxes.push_back(box);
+    }
+
+    m_Nodes.reserve(2 * m_Boxes.size());
+    m_Nodes.push_back({ glm::vec3(0.0f), glm::vec3(0.0f), 0, (int) m_Boxes.size() });
+    Subdivide(0);
+}
+
+void PickingBVH::Subdivide(int nodeIndex)
+{
+    Node& node = m_Nodes[nodeIndex];
+    node.Min = glm::vec3(std::numeric_limits<float>::max());
+    node.Max = glm::vec3(-std::numeric_limits<float>::max());
+    glm::vec3 centerMin = node.Min, centerMax = node.Max;
+    for (int i = node.First; i < node.First + node.Count; i++)
+    {
+        const Box& box = m_Boxes[m_Order[i]];
+        node.Min = glm::min(node.Min, box.Min);
+        node.Max = glm::max(node.Max, box.Max);
+        centerMin = glm::min(centerMin, box.Center);
+        centerMax = glm::max(centerMax, box.Center);
+    }
+    if (node.Count <= LEAF_SIZE)
+        return;
+
+    // Median split along the axis where the box centers spread the most
+    glm::vec3 extent = centerMax - centerMin;
+    int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
+    int first = node.First, count = node.Count, half = count / 2;
+    std::nth_element(m_Order.begin() + first, m_Order.begin() + first + half, m_Order.begin() + first + count,
+                     [this, axis](int a, int b) { return m_Boxes[a].Center[axis] < m_Boxes[b].Center[axis]; });
+
+    int left = (int) m_Nodes.size();
+    m_Nodes.push_back({ glm::vec3(0.0f), glm::vec3(0.0f), first, half });
+    m_Nodes.push_back({ glm::vec3(0.0f), glm::vec3(0.0f), first + half, count - half });
+    // push_back may have reallocated, so 'node' is not used past this point
+    m_Nodes[nodeIndex].First = left;
+    m_Nodes[nodeIndex].Count = 0;
+    Subdivide(left);
+    Subdivide(left + 1);
+}
+
+bool PickingBVH::IntersectBox(const Box& box, const Ray& ray, float maxDistance, RayHit& hit) const
+{
+    // In the box's local space the box is an axis-aligned unit cube. The direction is not
+    // renormalized, so distances along the local ray equal world distances.
+    glm::vec3 origin = glm::vec3(box.InverseModel * glm::vec4(ray.Origin, 1.0f));
+    glm::vec3 direction = glm::vec3(box.InverseModel * glm::vec4(ray.Direction, 0.0f));
+
+    float t;
+    int axis;
+    if (!IntersectAABB(glm::vec3(-0.5f), glm::vec3(0.5f), origin, 1.0f / direction, maxDistance, t, &axis))
+        return false;
+
+    // The entry face is on the slab that was crossed last, on the side facing the ray
+    glm::ivec3 normal(0);
+    normal[axis] = direction[axis] < 0.0f ? 1 : -1;
+    for (int face = 0; face < FACE_COUNT; face++)
+    {
+        if (CubeState::GetFaceNormal(face) == normal)
+            hit.Face = face;
+    }
+    hit.Distance = t;
+    hit.Point = ray.Origin + ray.Direction * t;
+    return true;
+}
+
+bool PickingBVH::Intersect(const Ray& ray, RayHit& hit) const
+{
+    if (m_Nodes.empty())
+        return false;
+
+    glm::vec3 inverseDirection = 1.0f / ray.Direction;
+    float closest = std::numeric_limits<float>::max();
+    bool found = false;
+
+    int stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0)
+    {
+        const Node& node = m_Nodes[stack[--stackSize]];
+        float tNode;
+        if (!IntersectAABB(node.Min, node.Max, ray.Origin, inverseDirection, closest, tNode))
+            continue;
+
+        if (node.Count > 0)
+        {
+            for (int i = node.First; i < node.First + node.Count; i++)
+            {
+                RayHit candidate;
+                if (IntersectBox(m_Boxes[m_Order[i]], ray, closest, candidate) && candidate.Distance < closest)
+                {
+                    closest = candidate.Distance;
+                    candidate.Object = m_Order[i];
+                    hit = candidate;
+                    found = true;
+                }
+            }
+        }
+        else if (stackSize + 2 <= 64)
+        {
+            stack[stackSize++] = node.First;
+            stack[stackSize++] = node.First + 1;
+        }
+    }
+    return found;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+struct Ray
+{
+    glm::vec3 Origin;
+    glm::vec3 Direction; // Normalized
+};
+
+struct RayHit
+{
+    int Object = -1;     // Index of the box in the list passed to Build()
+    int Face = -1;       // CubeFace of the box that was hit, in the box's local space
+    glm::vec3 Point;     // World-space hit point
+    float Distance = 0;  // Along the ray
+};
+
+// Bounding volume hierarchy over oriented boxes. Every box is the unit cube [-0.5, 0.5]^3
+// transformed by its model matrix, matching the cube mesh. Nodes bound the world-space AABBs of
+// their boxes; leaves test the ray against the exact oriented box in its local space.
+class PickingBVH
+{
+    private:
+        struct Node
+        {
+            glm::vec3 Min, Max;
+            int First, Count; // Leaf: range in m_Order. Inner node: Count == 0, children at First and First + 1
+        };
+
+        struct Box
+        {
+            glm::mat4 Model;
+            glm::mat4 InverseModel;
+            glm::vec3 Min, Max;
+            glm::vec3 Center;
+        };
+
+        static const int LEAF_SIZE = 4;
+
+        std::vector<Box> m_Boxes;
+        std::vector<int> m_Order;
+        std::vector<Node> m_Nodes;
+
+        void Subdivide(int nodeIndex);
+        bool IntersectBox(const Box& box, const Ray& ray, float maxDistance, RayHit& hit) const;
+    public:
+        void Build(const std::vector<glm::mat4>& models);
+
+        // Finds the closest box along the ray; returns false when nothing is hit.
+        bool Intersect(const Ray& ray, RayHit& hit) const;
+
+        inline unsigned int GetNodeCount() const { return (unsigned int) m_Nodes.size(); }
+};
@@ -0,0 +1,130 @@
+#include <ProgramCache.h>
+#include <GLExtensions.h>
+#include <Debugger.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+static void HashBytes(uint64_t& hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = (const unsigned char*) data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+}
+
+static void HashString(uint64_t& hash, const char* string)
+{
+    // The terminator is hashed too, so "ab" + "c" and "a" + "bc" differ
+    if (string)
+        HashBytes(hash, string, std::strlen(string) + 1);
+    else
+        HashBytes(hash, "", 1);
+}
+
+static std::string GetPath(uint64_t key)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long) key);
+    return std::string(ProgramCache::DIRECTORY) + "/" + name;
+}
+
+uint64_t ProgramCache::GetKey(const std::string& vertexSource, const std::string& fragmentSource)
+{
+    uint64_t hash = 14695981039346656037ull;
+    HashString(hash, vertexSource.c_str());
+    HashString(hash, fragmentSource.c_str());
+    HashString(hash, (const char*) glGetString(GL_VENDOR));
+    HashString(hash, (const char*) glGetString(GL_RENDERER));
+    HashString(hash, (const char*) glGetString(GL_VERSION));
+    return hash;
+}
+
+unsigned int ProgramCache::Load(uint64_t key)
+{
+    if (!GLExt.ARB_get_program_binary)
+        return 0;
+
+    std::ifstream stream(GetPath(key), std::ios::binary);
+    if (!stream)
+        return 0;
+
+    // File layout: the binary format enum followed by the driver's blob
+    GLenum format = 0;
+    if (!stream.read((char*) &format, sizeof(format)))
+        return 0;
+    // Reading through the stream buffer leaves the stream's state alone; an empty blob means
+    // the file was cut short
+    std::vector<char> binary((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    if (binary.empty())
+        return 0;
+
+    // An unknown format is a GL error rather than a failed link, so screen it out first
+    GLint formatCount = 0;
+    GLCall(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount));
+    std::vector<GLint> formats(formatCount);
+    GLCall(glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data()));
+    if (std::find(formats.begin(), formats.end(), (GLint) format) == formats.end())
+        return 0;
+
+    GLCall(unsigned int program = glCreateProgram());
+    GLCall(GLExt.ProgramBinary(program, format, binary.data(), (GLsizei) binary.size()));
+
+    // A driver is free to reject any binary, so a failed link just means compile as usual
+    int linked = GL_FALSE;
+    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+    if (linked == GL_FALSE)
+    {
+        GLCall(glDeleteProgram(program));
+        return 0;
+    }
+    return program;
+}
+
+void ProgramCache::PrepareProgram(unsigned int program)
+{
+    if (GLExt.ARB_get_program_binary)
+    {
+        GLCall(GLExt.ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
+}
+
+void ProgramCache::Save(uint64_t key, unsigned int program)
+{
+    if (!GLExt.ARB_get_program_binary)
+        return;
+
+    int length = 0;
+    GLCall(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    GLCall(GLExt.GetProgramBinary(program, length, &length, &format, binary.data()));
+
+    std::error_code error;
+    std::filesystem::create_directories(DIRECTORY, error);
+
+    // Written under a temporary name and renamed, so a crash never leaves a truncated binary behind
+    std::string path = GetPath(key);
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+        if (!stream)
+        {
+            std::cout << "Could not write program binary " << path << std::endl;
+            return;
+        }
+        stream.write((const char*) &format, sizeof(format));
+        stream.write(binary.data(), length);
+    }
+    std::filesystem::rename(temporary, path, error);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Stores linked programs on disk with glGetProgramBinary so later runs can skip compiling.
+// Binaries are keyed by a hash of the shader sources and the GL vendor, renderer and version
+// strings, so a driver update or a different GPU never sees a stale binary. Everything here is a
+// no-op when the context lacks ARB_get_program_binary.
+class ProgramCache
+{
+    public:
+        static constexpr const char* DIRECTORY = "shadercache";
+
+        static uint64_t GetKey(const std::string& vertexSource, const std::string& fragmentSource);
+
+        // Returns a linked program created from the cached binary, or 0 if there is no binary for
+        // the key or the driver rejects it.
+        static unsigned int Load(uint64_t key);
+
+        // Call before linking so the driver keeps the binary around for Save().
+        static void PrepareProgram(unsigned int program);
+        static void Save(uint64_t key, unsigned int program);
+};
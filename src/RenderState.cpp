@@ -0,0 +1,199 @@
+#include <RenderState.h>
+
+unsigned int RenderState::s_Program = RenderState::UNKNOWN;
+unsigned int RenderState::s_VertexArray = RenderState::UNKNOWN;
+unsigned int RenderState::s_ActiveTexture = RenderState::UNKNOWN;
+unsigned int RenderState::s_DrawFramebuffer = RenderState::UNKNOWN;
+unsigned int RenderState::s_ReadFramebuffer = RenderState::UNKNOWN;
+std::unordered_map<unsigned int, unsigned int> RenderState::s_ElementBuffers;
+std::unordered_map<unsigned int, unsigned int> RenderState::s_Buffers;
+std::map<std::pair<unsigned int, unsigned int>, unsigned int> RenderState::s_IndexedBuffers;
+std::map<std::pair<unsigned int, unsigned int>, unsigned int> RenderState::s_Textures;
+RenderStats RenderState::s_CurrentFrame;
+RenderStats RenderState::s_LastFrame;
+
+// Updates 'cached' to 'value' and reports whether the GL call is needed.
+static bool Changes(unsigned int& cached, unsigned int value)
+{
+    bool changed = cached != value;
+    cached = value;
+    RenderState::RecordCall(changed);
+    return changed;
+}
+
+void RenderState::UseProgram(unsigned int program)
+{
+    if (Changes(s_Program, program))
+    {
+        GLCall(glUseProgram(program));
+    }
+}
+
+void RenderState::BindVertexArray(unsigned int vertexArray)
+{
+    if (Changes(s_VertexArray, vertexArray))
+    {
+        GLCall(glBindVertexArray(vertexArray));
+    }
+}
+
+void RenderState::BindBuffer(unsigned int target, unsigned int buffer)
+{
+    std::unordered_map<unsigned int, unsigned int>::iterator it;
+    if (target == GL_ELEMENT_ARRAY_BUFFER)
+    {
+        // Without a known VAO the binding cannot be tracked
+        if (s_VertexArray == UNKNOWN)
+        {
+            RecordCall(true);
+            GLCall(glBindBuffer(target, buffer));
+            return;
+        }
+        it = s_ElementBuffers.emplace(s_VertexArray, UNKNOWN).first;
+    }
+    else
+    {
+        it = s_Buffers.emplace(target, UNKNOWN).first;
+    }
+
+    if (Changes(it->second, buffer))
+    {
+        GLCall(glBindBuffer(target, buffer));
+    }
+}
+
+void RenderState::BindBufferBase(unsigned int target, unsigned int index, unsigned int buffer)
+{
+    auto it = s_IndexedBuffers.emplace(std::make_pair(target, index), UNKNOWN).first;
+    if (Changes(it->second, buffer))
+    {
+        GLCall(glBindBufferBase(target, index, buffer));
+        s_Buffers[target] = buffer;
+    }
+}
+
+void RenderState::ActiveTexture(unsigned int slot)
+{
+    if (Changes(s_ActiveTexture, slot))
+    {
+        GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+    }
+}
+
+void RenderState::BindTexture(unsigned int target, unsigned int texture)
+{
+    if (s_ActiveTexture == UNKNOWN)
+        ActiveTexture(0);
+
+    auto it = s_Textures.emplace(std::make_pair(s_ActiveTexture, target), UNKNOWN).first;
+    if (Changes(it->second, texture))
+    {
+        GLCall(glBindTexture(target, texture));
+    }
+}
+
+void RenderState::BindFramebuffer(unsigned int target, unsigned int framebuffer)
+{
+    if (target == GL_FRAMEBUFFER)
+    {
+        bool changed = s_DrawFramebuffer != framebuffer || s_ReadFramebuffer != framebuffer;
+        s_DrawFramebuffer = framebuffer;
+        s_ReadFramebuffer = framebuffer;
+        RecordCall(changed);
+        if (changed)
+        {
+            GLCall(glBindFramebuffer(target, framebuffer));
+        }
+        return;
+    }
+
+    unsigned int& cached = target == GL_DRAW_FRAMEBUFFER ? s_DrawFramebuffer : s_ReadFramebuffer;
+    if (Changes(cached, framebuffer))
+    {
+        GLCall(glBindFramebuffer(target, framebuffer));
+    }
+}
+
+void RenderState::DeleteProgram(unsigned int program)
+{
+    GLCall(glDeleteProgram(program));
+    if (s_Program == program)
+        s_Program = UNKNOWN;
+}
+
+void RenderState::DeleteVertexArray(unsigned int vertexArray)
+{
+    GLCall(glDeleteVertexArrays(1, &vertexArray));
+    s_ElementBuffers.erase(vertexArray);
+    // Deleting the bound VAO reverts the binding to zero
+    if (s_VertexArray == vertexArray)
+        s_VertexArray = 0;
+}
+
+void RenderState::DeleteBuffer(unsigned int buffer)
+{
+    GLCall(glDeleteBuffers(1, &buffer));
+    for (auto& binding : s_Buffers)
+    {
+        if (binding.second == buffer)
+            binding.second = 0;
+    }
+    for (auto& binding : s_IndexedBuffers)
+    {
+        if (binding.second == buffer)
+            binding.second = 0;
+    }
+    // Buffers attached to other VAOs stay attached until those VAOs drop them
+    for (auto& binding : s_ElementBuffers)
+    {
+        if (binding.second == buffer)
+            binding.second = UNKNOWN;
+    }
+}
+
+void RenderState::DeleteTexture(unsigned int texture)
+{
+    GLCall(glDeleteTextures(1, &texture));
+    for (auto& binding : s_Textures)
+    {
+        if (binding.second == texture)
+            binding.second = 0;
+    }
+}
+
+void RenderState::DeleteFramebuffer(unsigned int framebuffer)
+{
+    GLCall(glDeleteFramebuffers(1, &framebuffer));
+    // Deleting a bound framebuffer reverts the binding to the default framebuffer
+    if (s_DrawFramebuffer == framebuffer)
+        s_DrawFramebuffer = 0;
+    if (s_ReadFramebuffer == framebuffer)
+        s_ReadFramebuffer = 0;
+}
+
+void RenderState::Invalidate()
+{
+    s_Program = UNKNOWN;
+    s_VertexArray = UNKNOWN;
+    s_ActiveTexture = UNKNOWN;
+    s_DrawFramebuffer = UNKNOWN;
+    s_ReadFramebuffer = UNKNOWN;
+    s_ElementBuffers.clear();
+    s_Buffers.clear();
+    s_IndexedBuffers.clear();
+    s_Textures.clear();
+}
+
+void RenderState::RecordCall(bool issued)
+{
+    if (issued)
+        s_CurrentFrame.Issued++;
+    else
+        s_CurrentFrame.Skipped++;
+}
+
+void RenderState::BeginFrame()
+{
+    s_LastFrame = s_CurrentFrame;
+    s_CurrentFrame = RenderStats();
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <Debugger.h>
+
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+// Number of state-changing GL calls made through RenderState during one frame.
+struct RenderStats
+{
+    unsigned int Issued = 0;  // Calls that reached the driver
+    unsigned int Skipped = 0; // Calls dropped because the state was already set
+};
+
+// Shadow copy of the GL bindings the engine uses. Every bind goes through here, so a call
+// that would not change anything (the same program, VAO, buffer or texture as last time)
+// never reaches the driver. Objects must be deleted through here too, so a recycled name is
+// never mistaken for the object that was bound before.
+class RenderState
+{
+    private:
+        static constexpr unsigned int UNKNOWN = 0xFFFFFFFF;
+
+        static unsigned int s_Program;
+        static unsigned int s_VertexArray;
+        static unsigned int s_ActiveTexture;
+        static unsigned int s_DrawFramebuffer;
+        static unsigned int s_ReadFramebuffer;
+        // The element array binding is part of the VAO, so it is tracked per VAO.
+        static std::unordered_map<unsigned int, unsigned int> s_ElementBuffers;
+        static std::unordered_map<unsigned int, unsigned int> s_Buffers;
+        // Keyed by (target, binding point)
+        static std::map<std::pair<unsigned int, unsigned int>, unsigned int> s_IndexedBuffers;
+        // Keyed by (texture unit, target)
+        static std::map<std::pair<unsigned int, unsigned int>, unsigned int> s_Textures;
+
+        static RenderStats s_CurrentFrame;
+        static RenderStats s_LastFrame;
+    public:
+        static void UseProgram(unsigned int program);
+        static void BindVertexArray(unsigned int vertexArray);
+        static void BindBuffer(unsigned int target, unsigned int buffer);
+        // Indexed binding (e.g. a uniform block binding point); also sets the target's generic binding.
+        static void BindBufferBase(unsigned int target, unsigned int index, unsigned int buffer);
+        static void ActiveTexture(unsigned int slot);
+        static void BindTexture(unsigned int target, unsigned int texture);
+        // GL_FRAMEBUFFER binds both the draw and the read framebuffer.
+        static void BindFramebuffer(unsigned int target, unsigned int framebuffer);
+
+        static void DeleteProgram(unsigned int program);
+        static void DeleteVertexArray(unsigned int vertexArray);
+        static void DeleteBuffer(unsigned int buffer);
+        static void DeleteTexture(unsigned int texture);
+        static void DeleteFramebuffer(unsigned int framebuffer);
+
+        // Forgets every cached binding, e.g. after code outside the engine touched GL state.
+        static void Invalidate();
+
+        // Used by callers that filter their own calls, like Shader's uniform value cache.
+        static void RecordCall(bool issued);
+
+        // Closes the current frame's counters; GetLastFrameStats() returns them until the next call.
+        static void BeginFrame();
+        static inline const RenderStats& GetLastFrameStats() { return s_LastFrame; }
+};
@@ -0,0 +1,138 @@
+#include <ResourceCache.h>
+
+#include <fstream>
+
+bool ResourceCache::HashFile(const std::string& filepath, uint64_t& hash)
+{
+    std::ifstream stream(filepath, std::ios::binary);
+    if (!stream)
+        return false;
+
+    hash = 14695981039346656037ull;
+    char buffer[4096];
+    while (stream)
+    {
+        stream.read(buffer, sizeof(buffer));
+        for (std::streamsize i = 0; i < stream.gcount(); i++)
+        {
+            hash ^= (unsigned char) buffer[i];
+            hash *= 1099511628211ull;
+        }
+    }
+    return true;
+}
+
+static std::filesystem::file_time_type GetWriteTime(const std::string& filepath)
+{
+    std::error_code error;
+    std::filesystem::file_time_type time = std::filesystem::last_write_time(filepath, error);
+    return error ? std::filesystem::file_time_type() : time;
+}
+
+template<typename T>
+static T Construct(const std::string& filepath, unsigned int variant);
+
+template<>
+Shader Construct<Shader>(const std::string& filepath, unsigned int variant)
+{
+    return Shader(filepath, variant);
+}
+
+// Content hash of one variant of a file
+static uint64_t GetVariantHash(uint64_t hash, unsigned int variant)
+{
+    return (hash ^ variant) * 1099511628211ull;
+}
+
+template<typename T>
+std::shared_ptr<T> ResourceCache::Acquire(Table<T>& table, const std::string& filepath, unsigned int variant)
+{
+    std::error_code error;
+    std::string key = std::filesystem::weakly_canonical(filepath, error).string();
+    if (error)
+        key = filepath;
+    key += '#' + std::to_string(variant);
+
+    Entry<T>& entry = table.ByPath[key];
+    if (std::shared_ptr<T> resource = entry.Resource.lock())
+    {
+        entry.Reloaded.reset();
+        return resource;
+    }
+
+    // Same contents under another path
+    uint64_t hash = 0;
+    bool readable = HashFile(filepath, hash);
+    std::shared_ptr<T> resource;
+    if (readable)
+    {
+        auto found = table.ByHash.find(GetVariantHash(hash, variant));
+        if (found != table.ByHash.end())
+            resource = found->second.lock();
+    }
+    if (!resource)
+    {
+        resource = std::make_shared<T>(Construct<T>(filepath, variant));
+        if (readable)
+            table.ByHash[GetVariantHash(hash, variant)] = resource;
+    }
+
+    entry.Resource = resource;
+    entry.Filepath = filepath;
+    entry.Variant = variant;
+    entry.Hash = hash;
+    entry.WriteTime = GetWriteTime(filepath);
+    return resource;
+}
+
+template<typename T>
+unsigned int ResourceCache::Reload(Table<T>& table)
+{
+    unsigned int reloaded = 0;
+    for (auto it = table.ByPath.begin(); it != table.ByPath.end();)
+    {
+        Entry<T>& entry = it->second;
+        std::shared_ptr<T> resource = entry.Resource.lock();
+        if (!resource)
+        {
+            it = table.ByPath.erase(it);
+            continue;
+        }
+
+        // The write time is only a cheap hint; the contents decide
+        std::filesystem::file_time_type time = GetWriteTime(entry.Filepath);
+        uint64_t hash = 0;
+        if (time != entry.WriteTime && HashFile(entry.Filepath, hash) && hash != entry.Hash)
+        {
+            // A new object rather than a rebuild in place: the old one may be shared with other
+            // paths that had the same contents, and stays in use if the new one is broken
+            std::shared_ptr<T> rebuilt = std::make_shared<T>(Construct<T>(entry.Filepath, entry.Variant));
+            if (rebuilt->IsValid())
+            {
+                table.ByHash[GetVariantHash(hash, entry.Variant)] = rebuilt;
+                entry.Resource = rebuilt;
+                entry.Reloaded = rebuilt;
+                entry.Hash = hash;
+                reloaded++;
+                std::cout << "Reloaded " << entry.Filepath << std::endl;
+            }
+            else
+            {
+                std::cout << "Failed to reload " << entry.Filepath << ", keeping the previous version" << std::endl;
+            }
+        }
+        entry.WriteTime = time;
+        ++it;
+    }
+    return reloaded;
+}
+
+std::shared_ptr<Shader> ResourceCache::GetShader(const std::string& filepath, unsigned int variant)
+{
+    return Acquire(m_Shaders, filepath, variant);
+}
+
+unsigned int ResourceCache::ReloadChanged()
+{
+    return Reload(m_Shaders);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <Shader.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// Hands out shared handles to shaders so each file is compiled once. Resources are found by path
+// and, for a path not seen before, by a hash of the file contents, so two copies of the same file
+// share one GL object as well. The cache only keeps weak references: a resource is released when
+// its last handle goes away. Shader variants (see ShaderVariant) are separate resources that
+// share their file.
+class ResourceCache
+{
+    private:
+        template<typename T>
+        struct Entry
+        {
+            std::weak_ptr<T> Resource;
+            std::shared_ptr<T> Reloaded; // Kept alive by the cache until it is acquired
+            std::string Filepath;
+            unsigned int Variant = 0;
+            uint64_t Hash = 0;
+            std::filesystem::file_time_type WriteTime;
+        };
+
+        template<typename T>
+        struct Table
+        {
+            std::unordered_map<std::string, Entry<T>> ByPath;
+            std::unordered_map<uint64_t, std::weak_ptr<T>> ByHash;
+        };
+
+        Table<Shader> m_Shaders;
+
+        template<typename T>
+        std::shared_ptr<T> Acquire(Table<T>& table, const std::string& filepath, unsigned int variant);
+
+        template<typename T>
+        unsigned int Reload(Table<T>& table);
+    public:
+        std::shared_ptr<Shader> GetShader(const std::string& filepath, unsigned int variant = 0);
+
+        // Rebuilds the live resources whose file contents changed since they were loaded. The new
+        // version replaces the resource of that path only and is handed out by the next Get call;
+        // existing handles keep the old one, as may other paths that shared it. A version that
+        // fails to compile is dropped and the old one stays. Returns how many were
+        // rebuilt, so that the caller can acquire its handles again; reloaded shaders start
+        // without any uniform values set.
+        unsigned int ReloadChanged();
+
+        // 64-bit FNV-1a of the file's bytes; returns false if the file cannot be read.
+        static bool HashFile(const std::string& filepath, uint64_t& hash);
+};
@@ -1,15 +1,34 @@
 #include "RubiksCube.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
-#include <GLFW/glfw3.h>
+#include <cmath>
 #include <Camera.h>
 
 // A small tolerance for floating point comparisons.
 const float epsilon = 0.0001f;
 
+// Turns that may wait for playback; further requests are refused until some have been played.
+static const size_t maxPendingTurns = 64;
+
+// Whether 'cube' lies in the layer at centerPos[axis] + offset.
+static bool isInLayer(const SmallCube* cube, const glm::vec3& centerPos, int axis, float offset) {
+    return std::abs(cube->getPosition()[axis] - (centerPos[axis] + offset)) < epsilon;
+}
+
+glm::mat4 RubiksCube::getLayerRotation(const glm::vec3& centerPos, int axis, float degrees) {
+    glm::vec3 rotationAxis(0.0f);
+    rotationAxis[axis] = 1.0f;
+    glm::mat4 toOrigin = glm::translate(glm::mat4(1.0f), -centerPos);
+    glm::mat4 rot = glm::rotate(glm::mat4(1.0f), glm::radians(degrees), rotationAxis);
+    glm::mat4 back = glm::translate(glm::mat4(1.0f), centerPos);
+    return back * rot * toOrigin;
+}
+
 RubiksCube::RubiksCube()
-        : RotationDirection(1), RotationAngle(90), Sensitivity(1.0f), pickingMode(false),
-          locks{ false, false, false, false, false, false }, centerCube(nullptr), selectedCube(nullptr)
+        : RotationDirection(1), RotationAngle(90), Sensitivity(1.0f), pickingMode(false), verbose(true),
+          locks{ false, false, false, false, false, false }, wallAngles{ 0, 0, 0, 0, 0, 0 }, turnSpeed(360.0f),
+          centerCube(nullptr), selectedCube(nullptr), cubeState(3),
+          turnAxis(0), turnOffset(0.0f), previousTurnAngle(0.0f), turnAngle(0.0f), pickingTurn(1.0f)
 {
     generateSmallCubes(); // Automatically create the 27 small cubes.
 }
@@ -28,7 +47,7 @@ void RubiksCube::generateSmallCubes() {
         for (int y = -1; y <= 1; ++y) {
             for (int z = -1; z <= 1; ++z) {
                 glm::vec3 pos(x, y, z);
-                SmallCube* cube = new SmallCube(pos, index);
+                SmallCube* cube = new SmallCube(pos, index, glm::ivec3(x + 1, y + 1, z + 1));
                 glm::mat4 model = glm::translate(glm::mat4(1.0f), pos);
                 cube->setModelMatrix(model);
                 smallCubes.push_back(cube);
@@ -45,180 +64,246 @@ std::vector<SmallCube*> RubiksCube::getSmallCubes() {
     return smallCubes;
 }
 
-glm::vec3 RubiksCube::getPosition() {
-    return centerCube->getPosition();
+// Object IDs are written by basic.shader as (cube index + 1) << 3 | face; 0 is the background.
+SmallCube* RubiksCube::selectByObjectID(unsigned int objectID, int* face) {
+    selectedCube = nullptr;
+    if (objectID != 0) {
+        int cubeIndex = static_cast<int>(objectID >> 3) - 1;
+        for (SmallCube* cube : smallCubes) {
+            if (cube->index == cubeIndex) {
+                selectedCube = cube;
+                break;
+            }
+        }
+    }
+    if (face)
+        *face = selectedCube ? static_cast<int>(objectID & 7) : -1;
+    return selectedCube;
+}
+
+glm::mat4 RubiksCube::getTurnedModelMatrix(const SmallCube* cube) const {
+    glm::vec3 centerPos = centerCube->getPosition();
+    if (turnAngle == 0.0f || !isInLayer(cube, centerPos, turnAxis, turnOffset))
+        return cube->getModelMatrix();
+    return getLayerRotation(centerPos, turnAxis, turnAngle) * cube->getModelMatrix();
 }
 
-// Render function: first a visible pass then (if enabled) a picking pass.
-void RubiksCube::render(Shader& shader, VertexArray& va, IndexBuffer& ib, glm::mat4 proj, glm::mat4 view, GLFWwindow* window) {
-    // ---- Visible Rendering Pass ----
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+// The hierarchy is kept between picks and only rebuilt once a cube's transform has changed, which
+// every matrix setter marks on the cube, or the turn being played back has moved on.
+void RubiksCube::updatePickingBVH() {
+    glm::mat4 turn = getLayerRotation(centerCube->getPosition(), turnAxis, turnAngle);
+    bool changed = pickingBVH.GetNodeCount() == 0 || turn != pickingTurn;
     for (SmallCube* cube : smallCubes) {
-        glm::mat4 model = cube->getRotationMatrix() * cube->getModelMatrix();
-        glm::mat4 mvp = proj * view * model;
+        changed = changed || cube->isTransformDirty();
+        cube->clearTransformDirty();
+    }
+    if (!changed)
+        return;
 
-        shader.Bind();
-        shader.SetPickingMode(false);
-        glm::vec4 color(1.0f);
-        shader.SetUniform4f("u_Color", color);
+    std::vector<glm::mat4> models;
+    models.reserve(smallCubes.size());
+    for (SmallCube* cube : smallCubes)
+        models.push_back(cube->getRotationMatrix() * getTurnedModelMatrix(cube));
+    pickingBVH.Build(models);
+    pickingTurn = turn;
+}
 
-        shader.SetUniformMat4f("u_MVP", mvp);
+SmallCube* RubiksCube::castRay(const Ray& ray, RayHit* hit) {
+    updatePickingBVH();
 
-        va.Bind();
-        ib.Bind();
-        GLCall(glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr));
+    RayHit result;
+    SmallCube* cube = pickingBVH.Intersect(ray, result) ? smallCubes[result.Object] : nullptr;
+    if (hit)
+        *hit = result;
+    return cube;
+}
 
-        shader.Unbind();
-    }
-    glfwSwapBuffers(window);
+SmallCube* RubiksCube::selectByRay(const Ray& ray, RayHit* hit) {
+    selectedCube = castRay(ray, hit);
+    return selectedCube;
+}
 
-    // ---- Picking Pass (if enabled) ----
-    if (pickingMode) {
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        for (SmallCube* cube : smallCubes) {
-            glm::mat4 model = cube->getRotationMatrix() * cube->getModelMatrix();
-            glm::mat4 mvp = proj * view * model;
-
-            shader.Bind();
-            // Each cube gets a unique color based on its index.
-            glm::vec3 uniqueColor = glm::vec3(cube->index, cube->index, cube->index);
-            glm::vec4 pickColor = glm::vec4(uniqueColor / 255.0f, 1.0f);
-            shader.SetPickingMode(true);
-            shader.SetUniform4f("u_Color", pickColor);
-            shader.SetUniformMat4f("u_MVP", mvp);
-
-            va.Bind();
-            ib.Bind();
-            GLCall(glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr));
-            shader.Unbind();
-        }
-        glFlush();
-        glFinish();
+glm::vec3 RubiksCube::getPosition() {
+    return centerCube->getPosition();
+}
+
+void RubiksCube::snapshot(CubeSnapshot& snapshot) const {
+    glm::vec3 centerPos = centerCube->getPosition();
+    bool turning = previousTurnAngle != 0.0f || turnAngle != 0.0f;
+    size_t count = smallCubes.size();
+    snapshot.Models.resize(count);
+    snapshot.Rotations.resize(count);
+    snapshot.Slots.resize(count);
+    snapshot.Turning.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const SmallCube* cube = smallCubes[i];
+        snapshot.Models[i] = cube->getModelMatrix();
+        snapshot.Rotations[i] = cube->getRotationMatrix();
+        snapshot.Slots[i] = cube->slot;
+        snapshot.Turning[i] = turning && isInLayer(cube, centerPos, turnAxis, turnOffset);
     }
+    snapshot.Stickers.assign(cubeState.GetStickers(), cubeState.GetStickers() + cubeState.GetStickerCount());
+
+    snapshot.Center = centerPos;
+    snapshot.TurnAxis = turnAxis;
+    snapshot.PreviousTurnAngle = previousTurnAngle;
+    snapshot.TurnAngle = turnAngle;
+    snapshot.HalfTurned = false;
+    for (int wall = 0; wall < 6; ++wall)
+        snapshot.HalfTurned = snapshot.HalfTurned || wallAngles[wall] != 0;
+    snapshot.Selected = selectedCube ? selectedCube->index : -1;
 }
 
 // ======================
 // Rotation Functions
 // ======================
 
-// Rotate the RIGHT wall (cubes with x == center.x + 1) about the X-axis.
-void RubiksCube::rotateRightWall() {
-    std::cout << "Rotating Right Wall by " << (RotationAngle * RotationDirection) << " degrees\n";
-    glm::vec3 centerPos = centerCube->getPosition();
-
-    for (SmallCube* cube : smallCubes) {
-        if (std::abs(cube->getPosition().x - (centerPos.x + 1)) < epsilon) {
-            glm::mat4 toOrigin = glm::translate(glm::mat4(1.0f), -centerPos);
-            glm::mat4 rot = glm::rotate(glm::mat4(1.0f),
-                                        glm::radians(static_cast<float>(RotationAngle * RotationDirection)),
-                                        glm::vec3(1.0f, 0.0f, 0.0f));
-            glm::mat4 back = glm::translate(glm::mat4(1.0f), centerPos);
-            glm::mat4 finalTransform = back * rot * toOrigin;
-            cube->setModelMatrix(finalTransform * cube->getModelMatrix());
-        }
+// Shared implementation of the six wall rotations, turning by the current angle and direction.
+void RubiksCube::rotateWall(int wall, int axis, float offset) {
+    static const char* wallNames[6] = { "Right", "Left", "Up", "Down", "Back", "Front" };
+    if (pendingTurns.size() >= maxPendingTurns) {
+        if (verbose)
+            std::cout << "Too many turns waiting, " << wallNames[wall] << " Wall turn refused\n";
+        return;
     }
+    if (verbose)
+        std::cout << "Rotating " << wallNames[wall] << " Wall by " << (RotationAngle * RotationDirection) << " degrees\n";
     if (std::abs(RotationAngle) == 45)
-        locks[0] = !locks[0];
+        locks[wall] = !locks[wall];
+
+    queueTurn(wall, axis, offset, RotationAngle * RotationDirection);
 }
 
-// Rotate the LEFT wall (cubes with x == center.x - 1) about the X-axis.
-void RubiksCube::rotateLeftWall() {
-    std::cout << "Rotating Left Wall by " << (RotationAngle * RotationDirection) << " degrees\n";
-    glm::vec3 centerPos = centerCube->getPosition();
+// Walls use the same numbering as rotateWall: 0 Right, 1 Left, 2 Up, 3 Down, 4 Back, 5 Front.
+bool RubiksCube::applyMove(const CubeMove& move) {
+    if (pendingTurns.size() >= maxPendingTurns)
+        return false;
+    for (int wall = 0; wall < 6; ++wall) {
+        if (locks[wall] && wall / 2 != move.Axis)
+            return false;
+    }
 
-    for (SmallCube* cube : smallCubes) {
-        if (std::abs(cube->getPosition().x - (centerPos.x - 1)) < epsilon) {
-            glm::mat4 toOrigin = glm::translate(glm::mat4(1.0f), -centerPos);
-            glm::mat4 rot = glm::rotate(glm::mat4(1.0f),
-                                        glm::radians(static_cast<float>(RotationAngle * RotationDirection)),
-                                        glm::vec3(1.0f, 0.0f, 0.0f));
-            glm::mat4 back = glm::translate(glm::mat4(1.0f), centerPos);
-            glm::mat4 finalTransform = back * rot * toOrigin;
-            cube->setModelMatrix(finalTransform * cube->getModelMatrix());
-        }
+    static const char axisNames[3] = { 'X', 'Y', 'Z' };
+    int degrees = 90 * move.QuarterTurns;
+    if (verbose)
+        std::cout << "Turning layer " << move.Layer << " around " << axisNames[move.Axis] << " by " << degrees << " degrees\n";
+
+    int lastLayer = cubeState.GetSize() - 1;
+    int wall = -1;
+    if (move.Layer == lastLayer)
+        wall = move.Axis * 2;
+    else if (move.Layer == 0)
+        wall = move.Axis * 2 + 1;
+
+    queueTurn(wall, move.Axis, static_cast<float>(move.Layer) - lastLayer / 2.0f, degrees);
+    return true;
+}
+
+// Locks are taken when a turn is requested, so requests are checked against the state the cube
+// will be in once everything queued before them has been played.
+void RubiksCube::queueTurn(int wall, int axis, float offset, int degrees) {
+    PendingTurn turn = { wall, axis, offset, degrees };
+    if (turnSpeed <= 0.0f && pendingTurns.empty())
+        applyTurn(turn);
+    else
+        pendingTurns.push_back(turn);
+}
+
+void RubiksCube::applyTurn(const PendingTurn& turn) {
+    int middleAngle = 0;
+    turnLayer(turn.axis, turn.offset, turn.degrees, turn.wall >= 0 ? wallAngles[turn.wall] : middleAngle);
+}
+
+void RubiksCube::update(float dt) {
+    previousTurnAngle = turnAngle;
+    if (pendingTurns.empty())
+        return;
+
+    // Playback was switched off while turns were waiting
+    if (turnSpeed <= 0.0f) {
+        for (const PendingTurn& turn : pendingTurns)
+            applyTurn(turn);
+        pendingTurns.clear();
+        previousTurnAngle = turnAngle = 0.0f;
+        return;
+    }
+
+    const PendingTurn& turn = pendingTurns.front();
+    if (turnAngle == 0.0f) {
+        turnAxis = turn.axis;
+        turnOffset = turn.offset;
+        previousTurnAngle = 0.0f;
+    }
+
+    // Turns waiting behind this one (e.g. from the Mixer) speed it up
+    float step = turnSpeed * dt * static_cast<float>(pendingTurns.size());
+    turnAngle += turn.degrees > 0 ? step : -step;
+    if (std::abs(turnAngle) >= std::abs(turn.degrees)) {
+        // The cubes' transforms now hold the whole turn; the frames until the next tick
+        // interpolate from the previous angle measured against them.
+        previousTurnAngle -= turn.degrees;
+        turnAngle = 0.0f;
+        applyTurn(turn);
+        pendingTurns.pop_front();
     }
-    if (std::abs(RotationAngle) == 45)
-        locks[1] = !locks[1];
 }
 
-// Rotate the UP wall (cubes with y == center.y + 1) about the Y-axis.
-void RubiksCube::rotateUpWall() {
-    std::cout << "Rotating Up Wall by " << (RotationAngle * RotationDirection) << " degrees\n";
+// Shared implementation of the wall rotations and moves. The layer's cubes are turned geometrically
+// around the cube center; once the layer has accumulated a full quarter turn, the turn is applied
+// to cubeState instead and the cubes snap back to their home slots, so the sticker colors carry
+// the puzzle state and the transforms only hold the unfinished (45 degree) part of a turn.
+void RubiksCube::turnLayer(int axis, float offset, int degrees, int& layerAngle) {
     glm::vec3 centerPos = centerCube->getPosition();
+    glm::mat4 finalTransform = getLayerRotation(centerPos, axis, static_cast<float>(degrees));
 
+    std::vector<SmallCube*> layerCubes;
     for (SmallCube* cube : smallCubes) {
-        if (std::abs(cube->getPosition().y - (centerPos.y + 1)) < epsilon) {
-            glm::mat4 toOrigin = glm::translate(glm::mat4(1.0f), -centerPos);
-            glm::mat4 rot = glm::rotate(glm::mat4(1.0f),
-                                        glm::radians(static_cast<float>(RotationAngle * RotationDirection)),
-                                        glm::vec3(0.0f, 1.0f, 0.0f));
-            glm::mat4 back = glm::translate(glm::mat4(1.0f), centerPos);
-            glm::mat4 finalTransform = back * rot * toOrigin;
+        if (isInLayer(cube, centerPos, axis, offset)) {
             cube->setModelMatrix(finalTransform * cube->getModelMatrix());
+            layerCubes.push_back(cube);
         }
     }
-    if (std::abs(RotationAngle) == 45)
-        locks[2] = !locks[2];
+
+    layerAngle += degrees;
+    if (layerAngle % 90 == 0) {
+        int layer = static_cast<int>(std::lround(offset + (cubeState.GetSize() - 1) / 2.0f));
+        cubeState.ApplyQuarterTurn(axis, layer, layerAngle / 90);
+        layerAngle = 0;
+        for (SmallCube* cube : layerCubes) {
+            glm::vec3 home = centerPos + glm::vec3(cube->slot - glm::ivec3(1));
+            cube->setModelMatrix(glm::translate(glm::mat4(1.0f), home));
+        }
+    }
+}
+
+// Rotate the RIGHT wall (cubes with x == center.x + 1) about the X-axis.
+void RubiksCube::rotateRightWall() {
+    rotateWall(0, 0, 1.0f);
+}
+
+// Rotate the LEFT wall (cubes with x == center.x - 1) about the X-axis.
+void RubiksCube::rotateLeftWall() {
+    rotateWall(1, 0, -1.0f);
+}
+
+// Rotate the UP wall (cubes with y == center.y + 1) about the Y-axis.
+void RubiksCube::rotateUpWall() {
+    rotateWall(2, 1, 1.0f);
 }
 
 // Rotate the DOWN wall (cubes with y == center.y - 1) about the Y-axis.
 void RubiksCube::rotateDownWall() {
-    std::cout << "Rotating Down Wall by " << (RotationAngle * RotationDirection) << " degrees\n";
-    glm::vec3 centerPos = centerCube->getPosition();
-
-    for (SmallCube* cube : smallCubes) {
-        if (std::abs(cube->getPosition().y - (centerPos.y - 1)) < epsilon) {
-            glm::mat4 toOrigin = glm::translate(glm::mat4(1.0f), -centerPos);
-            glm::mat4 rot = glm::rotate(glm::mat4(1.0f),
-                                        glm::radians(static_cast<float>(RotationAngle * RotationDirection)),
-                                        glm::vec3(0.0f, 1.0f, 0.0f));
-            glm::mat4 back = glm::translate(glm::mat4(1.0f), centerPos);
-            glm::mat4 finalTransform = back * rot * toOrigin;
-            cube->setModelMatrix(finalTransform * cube->getModelMatrix());
-        }
-    }
-    if (std::abs(RotationAngle) == 45)
-        locks[3] = !locks[3];
+    rotateWall(3, 1, -1.0f);
 }
 
 // Rotate the BACK wall (cubes with z == center.z + 1) about the Z-axis.
 void RubiksCube::rotateBackWall() {
-    std::cout << "Rotating Back Wall by " << (RotationAngle * RotationDirection) << " degrees\n";
-    glm::vec3 centerPos = centerCube->getPosition();
-
-    for (SmallCube* cube : smallCubes) {
-        if (std::abs(cube->getPosition().z - (centerPos.z + 1)) < epsilon) {
-            glm::mat4 toOrigin = glm::translate(glm::mat4(1.0f), -centerPos);
-            glm::mat4 rot = glm::rotate(glm::mat4(1.0f),
-                                        glm::radians(static_cast<float>(RotationAngle * RotationDirection)),
-                                        glm::vec3(0.0f, 0.0f, 1.0f));
-            glm::mat4 back = glm::translate(glm::mat4(1.0f), centerPos);
-            glm::mat4 finalTransform = back * rot * toOrigin;
-            cube->setModelMatrix(finalTransform * cube->getModelMatrix());
-        }
-    }
-    if (std::abs(RotationAngle) == 45)
-        locks[4] = !locks[4];
+    rotateWall(4, 2, 1.0f);
 }
 
 // Rotate the FRONT wall (cubes with z == center.z - 1) about the Z-axis.
 void RubiksCube::rotateFrontWall() {
-    std::cout << "Rotating Front Wall by " << (RotationAngle * RotationDirection) << " degrees\n";
-    glm::vec3 centerPos = centerCube->getPosition();
-
-    for (SmallCube* cube : smallCubes) {
-        if (std::abs(cube->getPosition().z - (centerPos.z - 1)) < epsilon) {
-            glm::mat4 toOrigin = glm::translate(glm::mat4(1.0f), -centerPos);
-            glm::mat4 rot = glm::rotate(glm::mat4(1.0f),
-                                        glm::radians(static_cast<float>(RotationAngle * RotationDirection)),
-                                        glm::vec3(0.0f, 0.0f, 1.0f));
-            glm::mat4 back = glm::translate(glm::mat4(1.0f), centerPos);
-            glm::mat4 finalTransform = back * rot * toOrigin;
-            cube->setModelMatrix(finalTransform * cube->getModelMatrix());
-        }
-    }
-    if (std::abs(RotationAngle) == 45)
-        locks[5] = !locks[5];
+    rotateWall(5, 2, -1.0f);
 }
 
 // ======================
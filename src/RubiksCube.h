@@ -1,13 +1,13 @@
 #ifndef RUBIKSCUBE_H
 #define RUBIKSCUBE_H
 
+#include <deque>
 #include <vector>
 #include "SmallCube.h"
+#include <CubeState.h>
+#include <FrameSnapshot.h>
+#include <PickingBVH.h>
 #include <glm/glm.hpp>
-#include <Shader.h>
-#include <VertexArray.h>
-#include <IndexBuffer.h>
-#include <GLFW/glfw3.h>
 
 class RubiksCube {
 public:
@@ -16,22 +16,43 @@ public:
     int RotationAngle;     // Current rotation angle in degrees.
     float Sensitivity;     // Used for arrow key translations.
     bool pickingMode;      // Toggle for color picking mode.
+    bool verbose;          // Log every turn to the console.
 
     // Locks to prevent overlapping rotations on specific faces.
     bool locks[6];
 
+    // Angle (in degrees) each wall has turned since its last completed quarter turn.
+    int wallAngles[6];
+
+    // Degrees per second at which update() plays back the requested wall turns and moves; 0
+    // applies them at once.
+    float turnSpeed;
+
     // Cube data.
     std::vector<SmallCube*> smallCubes;
     SmallCube* centerCube;
     SmallCube* selectedCube;
 
+    // Sticker colors of the puzzle, updated whenever a wall completes a quarter turn.
+    CubeState cubeState;
+
     // Constructor and Destructor.
     RubiksCube();
     ~RubiksCube();
 
-    // Cube Generation & Rendering.
+    // Cube Generation.
     void generateSmallCubes();
-    void render(Shader& shader, VertexArray& va, IndexBuffer& ib, glm::mat4 proj, glm::mat4 view, GLFWwindow* window);
+
+    // Copies what the renderer needs after a tick into 'snapshot' (drawn by CubeRenderer),
+    // reusing its storage.
+    void snapshot(CubeSnapshot& snapshot) const;
+
+    // Rotation by 'degrees' about the axis through 'centerPos'.
+    static glm::mat4 getLayerRotation(const glm::vec3& centerPos, int axis, float degrees);
+
+    // The cube's model matrix turned with its layer by the turn being played back, as far as the
+    // latest tick took it. Frames are drawn at most one tick behind that (see CubeRenderer::Draw).
+    glm::mat4 getTurnedModelMatrix(const SmallCube* cube) const;
 
     // Face Rotations.
     void rotateRightWall();
@@ -41,6 +62,14 @@ public:
     void rotateBackWall();
     void rotateFrontWall();
 
+    // Turns any layer, including the middle ones, by whole quarter turns. Refused (returns false)
+    // while a wall on another axis is stuck halfway or too many turns wait for playback.
+    bool applyMove(const CubeMove& move);
+
+    // Simulation tick: advances the turn being played back by 'dt' seconds. Turns are played
+    // one after another, faster while more are waiting.
+    void update(float dt);
+
     // Checks if a particular face can be rotated.
     bool canRotateRightWall();
     bool canRotateLeftWall();
@@ -55,12 +84,57 @@ public:
     void LeftArrow();
     void RightArrow();
 
+    // Picking: selects the cube behind an object ID read from the scene's ID attachment
+    // (nullptr for the background) and optionally reports the face that was hit.
+    SmallCube* selectByObjectID(unsigned int objectID, int* face = nullptr);
+
+    // Picking without the GPU: returns the cube hit first by a world-space ray (nullptr when the
+    // ray misses) and optionally reports the face and hit point. Leaves the selection alone.
+    SmallCube* castRay(const Ray& ray, RayHit* hit = nullptr);
+
+    // Like castRay, and selects the cube that was hit (none when the ray misses).
+    SmallCube* selectByRay(const Ray& ray, RayHit* hit = nullptr);
+
     // Getters.
     glm::vec3 getPosition();
     std::vector<SmallCube*> getSmallCubes();
 
 private:
-    // (Additional private members can be added here if needed)
+    // A requested turn, handed to turnLayer once it has been played back. 'wall' is -1 for the
+    // middle layers, which keep no angle between turns.
+    struct PendingTurn {
+        int wall;
+        int axis;
+        float offset;
+        int degrees;
+    };
+    std::deque<PendingTurn> pendingTurns;
+
+    // Playback of the front turn: its layer, and the layer's angle after the previous and the
+    // latest tick, relative to the cubes' transforms.
+    int turnAxis;
+    float turnOffset;
+    float previousTurnAngle;
+    float turnAngle;
+
+    // Plays 'degrees' back before applying it, or applies it at once when turnSpeed is 0.
+    void queueTurn(int wall, int axis, float offset, int degrees);
+    void applyTurn(const PendingTurn& turn);
+
+    // Turns the wall whose cubes sit at centerPos[axis] + offset, and folds every completed
+    // quarter turn into cubeState so the wall's cubes can return to their home slots.
+    void rotateWall(int wall, int axis, float offset);
+
+    // Turns the cubes at centerPos[axis] + offset by 'degrees' and adds them to 'layerAngle';
+    // completed quarter turns go to cubeState and the layer's cubes snap back home.
+    void turnLayer(int axis, float offset, int degrees, int& layerAngle);
+
+    // Cube boxes for ray picking, built from the cubes' transforms, and the turn they include.
+    PickingBVH pickingBVH;
+    glm::mat4 pickingTurn;
+
+    // Rebuilds pickingBVH when a cube's transform or the turn changed since it was last built.
+    void updatePickingBVH();
 };
 
 #endif // RUBIKSCUBE_H
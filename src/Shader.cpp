@@ -1,19 +1,97 @@
 #include <Shader.h>
+#include <RenderState.h>
+#include <ProgramCache.h>
+#include <UniformBuffer.h>
 
-Shader::Shader(const std::string& filepath)
-        : m_Filepath(filepath), m_RendererID(0)
+#include <cstring>
+
+// Interned uniform names; the map is only touched when a handle is built
+struct UniformNames
+{
+    std::unordered_map<std::string, int> IDs;
+    std::vector<std::string> Names;
+};
+
+static UniformNames& GetUniformNames()
+{
+    static UniformNames names;
+    return names;
+}
+
+static int InternUniformName(const std::string& name)
+{
+    UniformNames& names = GetUniformNames();
+    auto found = names.IDs.find(name);
+    if (found != names.IDs.end())
+        return found->second;
+
+    int id = (int) names.Names.size();
+    names.IDs[name] = id;
+    names.Names.push_back(name);
+    return id;
+}
+
+Uniform::Uniform(const char* name)
+    : ID(InternUniformName(name))
+{
+}
+
+Uniform::Uniform(const std::string& name)
+    : ID(InternUniformName(name))
+{
+}
+
+const std::string& Uniform::GetName(int id)
+{
+    return GetUniformNames().Names[id];
+}
+
+Shader::Shader(const std::string& filepath, unsigned int variant)
+        : m_Filepath(filepath), m_Variant(variant), m_RendererID(0)
 {
-    ShaderProgramSource source = ParseShader(filepath);
+    ShaderProgramSource source = ParseShader(filepath, variant);
     m_RendererID = CreateShader(source.VertexSource, source.FragmentSource);
+    ReflectUniforms();
 }
 
 Shader::~Shader()
 {
-    GLCall(glDeleteProgram(m_RendererID));
+    if (m_RendererID)
+        RenderState::DeleteProgram(m_RendererID);
+}
+
+Shader::Shader(Shader&& other) noexcept
+    : m_Filepath(std::move(other.m_Filepath)), m_Variant(other.m_Variant), m_RendererID(other.m_RendererID),
+      m_Uniforms(std::move(other.m_Uniforms))
+{
+    other.m_RendererID = 0;
+}
+
+Shader& Shader::operator=(Shader&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_RendererID)
+            RenderState::DeleteProgram(m_RendererID);
+        m_Filepath = std::move(other.m_Filepath);
+        m_Variant = other.m_Variant;
+        m_RendererID = other.m_RendererID;
+        m_Uniforms = std::move(other.m_Uniforms);
+        other.m_RendererID = 0;
+    }
+    return *this;
 }
 
-ShaderProgramSource Shader::ParseShader(const std::string& filepath)
+ShaderProgramSource Shader::ParseShader(const std::string& filepath, unsigned int variant)
 {
+    static const char* variantNames[] = { "PICKING", "INSTANCED", "TEXTURED" };
+    std::string defines;
+    for (unsigned int bit = 0; bit < sizeof(variantNames) / sizeof(variantNames[0]); bit++)
+    {
+        if (variant & (1u << bit))
+            defines += std::string("#define ") + variantNames[bit] + "\n";
+    }
+
     std::ifstream stream(filepath);
 
     enum class ShaderType
@@ -37,9 +115,12 @@ ShaderProgramSource Shader::ParseShader(const std::string& filepath)
                 type = ShaderType::FRAGMENT;
             }
         }
-        else
+        else if (type != ShaderType::NONE) // Lines before the first #shader (e.g. comments) are ignored
         {
             ss[(int)type] << line << '\n';
+            // GLSL wants #version first, so the variant defines go right after it
+            if (line.find("#version") != std::string::npos)
+                ss[(int)type] << defines;
         }
     }
 
@@ -72,68 +153,190 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
 
 unsigned int Shader::CreateShader(const std::string& vertexShader, const std::string& fragmentShader)
 {
+    uint64_t key = ProgramCache::GetKey(vertexShader, fragmentShader);
+    if (unsigned int cached = ProgramCache::Load(key))
+        return cached;
+
     GLCall(int program = glCreateProgram());
     unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexShader);
     unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
 
+    // A stage that failed to compile leaves the program unlinked, which IsValid reports
+    if (!vs || !fs)
+    {
+        if (vs)
+        {
+            GLCall(glDeleteShader(vs));
+        }
+        if (fs)
+        {
+            GLCall(glDeleteShader(fs));
+        }
+        return program;
+    }
+
     GLCall(glAttachShader(program, vs));
     GLCall(glAttachShader(program, fs));
+    ProgramCache::PrepareProgram(program);
     GLCall(glLinkProgram(program));
     GLCall(glValidateProgram(program));
 
     GLCall(glDeleteShader(vs));
     GLCall(glDeleteShader(fs));
 
+    // Only programs that linked are worth caching; a failed one should fail loudly next run too
+    int linked = GL_FALSE;
+    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+    if (linked == GL_TRUE)
+        ProgramCache::Save(key, program);
+
     return program;
 }
 
+bool Shader::IsValid() const
+{
+    int linked = GL_FALSE;
+    GLCall(glGetProgramiv(m_RendererID, GL_LINK_STATUS, &linked));
+    return linked == GL_TRUE;
+}
+
 void Shader::Bind() const
 {
-    GLCall(glUseProgram(m_RendererID));
+    RenderState::UseProgram(m_RendererID);
 }
 
 void Shader::Unbind() const
 {
-    GLCall(glUseProgram(0));
+    RenderState::UseProgram(0);
 }
 
-void Shader::SetUniform1i(const std::string& name, int value)
+void Shader::SetUniform1i(const Uniform& uniform, int value)
 {
-    GLCall(glUniform1i(GetUniformLocation(name), value));
+    if (UniformChanged(uniform, &value, sizeof(value)))
+    {
+        GLCall(glUniform1i(GetUniformLocation(uniform), value));
+    }
 }
 
-void Shader::SetUniform1f(const std::string& name, float value)
+void Shader::SetUniform1iv(const Uniform& uniform, int count, const int* values)
 {
-    GLCall(glUniform1f(GetUniformLocation(name), value));
+    if (UniformChanged(uniform, values, count * sizeof(int)))
+    {
+        GLCall(glUniform1iv(GetUniformLocation(uniform), count, values));
+    }
 }
 
-void Shader::SetUniform4f(const std::string& name, glm::vec4& value)
+void Shader::SetUniform1f(const Uniform& uniform, float value)
 {
-    GLCall(glUniform4f(GetUniformLocation(name), value.x, value.y, value.z, value.w));
+    if (UniformChanged(uniform, &value, sizeof(value)))
+    {
+        GLCall(glUniform1f(GetUniformLocation(uniform), value));
+    }
 }
 
-void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& matrix)
+void Shader::SetUniform3i(const Uniform& uniform, const glm::ivec3& value)
 {
-    GLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]));
+    if (UniformChanged(uniform, &value, sizeof(value)))
+    {
+        GLCall(glUniform3i(GetUniformLocation(uniform), value.x, value.y, value.z));
+    }
 }
 
-int Shader::GetUniformLocation(const std::string& name)
+void Shader::SetUniform4f(const Uniform& uniform, const glm::vec4& value)
 {
-    if (m_UniformLocationCache.find(name) != m_UniformLocationCache.end())
+    if (UniformChanged(uniform, &value, sizeof(value)))
     {
-        return m_UniformLocationCache[name];
+        GLCall(glUniform4f(GetUniformLocation(uniform), value.x, value.y, value.z, value.w));
     }
+}
 
-    GLCall(int location = glGetUniformLocation(m_RendererID, name.c_str()));
-    if (location == -1)
+void Shader::SetUniformMat4f(const Uniform& uniform, const glm::mat4& matrix)
+{
+    if (UniformChanged(uniform, &matrix[0][0], sizeof(matrix)))
     {
-        std::cout << "Warning: uniform '" << name << "' doesn't exist!" << std::endl;
+        GLCall(glUniformMatrix4fv(GetUniformLocation(uniform), 1, GL_FALSE, &matrix[0][0]));
     }
+}
+
+// Lists the program's active uniforms once, so setters never query GL or hash a name, and
+// attaches the program's uniform blocks to their binding points.
+void Shader::ReflectUniforms()
+{
+    m_Uniforms.clear();
+    if (!m_RendererID)
+        return;
 
-    m_UniformLocationCache[name] = location;
-    return location;
+    int count = 0, maxLength = 0;
+    GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &count));
+    GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength));
+    std::vector<char> buffer(maxLength + 1);
+    for (int i = 0; i < count; i++)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        GLCall(glGetActiveUniform(m_RendererID, i, (GLsizei) buffer.size(), &length, &size, &type, buffer.data()));
+        std::string name(buffer.data(), length);
+
+        // Arrays are reported as "name[0]" but set through their plain name
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+            name.resize(name.size() - 3);
+
+        // Members of uniform blocks have no location and are not set through the program
+        GLCall(int location = glGetUniformLocation(m_RendererID, name.c_str()));
+        if (location == -1)
+            continue;
+
+        int id = Uniform(name).ID;
+        if (id >= (int) m_Uniforms.size())
+            m_Uniforms.resize(id + 1);
+        m_Uniforms[id].Location = location;
+    }
+
+    // Shared blocks go to their fixed binding points, so their buffers are bound once for all shaders
+    int blockCount = 0;
+    GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount));
+    for (int i = 0; i < blockCount; i++)
+    {
+        GLsizei length = 0;
+        buffer.resize(256);
+        GLCall(glGetActiveUniformBlockName(m_RendererID, i, (GLsizei) buffer.size(), &length, buffer.data()));
+        int binding = UniformBlock::GetBinding(std::string(buffer.data(), length));
+        if (binding == -1)
+        {
+            std::cout << "Warning: uniform block '" << std::string(buffer.data(), length) << "' has no binding point" << std::endl;
+            continue;
+        }
+        GLCall(glUniformBlockBinding(m_RendererID, i, binding));
+    }
 }
 
-void Shader::SetPickingMode(bool pickingMode) {
-    SetUniform1i("u_PickingMode", pickingMode ? 1 : 0);
+int Shader::GetUniformLocation(const Uniform& uniform)
+{
+    return uniform.ID < (int) m_Uniforms.size() ? m_Uniforms[uniform.ID].Location : -1;
+}
+
+// Uniform values are program state, so a value the program already holds is never sent again.
+bool Shader::UniformChanged(const Uniform& uniform, const void* data, unsigned int size)
+{
+    // Setting a missing uniform is a no-op in GL anyway
+    if (GetUniformLocation(uniform) == -1)
+    {
+        if (uniform.ID >= (int) m_Uniforms.size())
+            m_Uniforms.resize(uniform.ID + 1);
+        if (!m_Uniforms[uniform.ID].Warned)
+        {
+            std::cout << "Warning: uniform '" << Uniform::GetName(uniform.ID) << "' doesn't exist!" << std::endl;
+            m_Uniforms[uniform.ID].Warned = true;
+        }
+        RenderState::RecordCall(false);
+        return false;
+    }
+
+    std::vector<unsigned char>& cached = m_Uniforms[uniform.ID].Value;
+    bool changed = cached.size() != size || std::memcmp(cached.data(), data, size) != 0;
+    if (changed)
+        cached.assign((const unsigned char*) data, (const unsigned char*) data + size);
+    RenderState::RecordCall(changed);
+    return changed;
 }
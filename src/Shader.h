@@ -10,6 +10,7 @@
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 struct ShaderProgramSource
 {
@@ -17,29 +18,80 @@ struct ShaderProgramSource
     std::string FragmentSource;
 };
 
+// Variant bits of a shader file. Each set bit is compiled in as a #define of the same name, so a
+// variant carries only the code it needs instead of branching on a mode uniform.
+namespace ShaderVariant
+{
+    enum : unsigned int
+    {
+        PICKING   = 1 << 0, // Writes the object ID attachment
+        INSTANCED = 1 << 1, // Per-instance puzzle offset and index in attribute 3
+        TEXTURED  = 1 << 2, // Samples the sticker texture array
+        COUNT     = 1 << 3  // Number of distinct variants
+    };
+}
+
+// Handle to a uniform name. Names are interned into small IDs shared by every shader, and each
+// shader maps IDs to its locations when it links, so setting a uniform through a handle is an
+// array index. Building a handle hashes the name: code that sets a uniform per draw keeps a
+// static handle, while setup code can pass a string literal.
+struct Uniform
+{
+    int ID;
+
+    Uniform(const char* name);
+    Uniform(const std::string& name);
+
+    static const std::string& GetName(int id);
+};
+
 class Shader
 {
 private:
+    // Active uniform found by reflection at link time, with the value last sent to it
+    struct UniformSlot
+    {
+        int Location = -1;
+        bool Warned = false;
+        std::vector<unsigned char> Value;
+    };
+
     std::string m_Filepath;
+    unsigned int m_Variant;
     unsigned int m_RendererID;
-    std::unordered_map<std::string, int> m_UniformLocationCache;
+    std::vector<UniformSlot> m_Uniforms; // Indexed by Uniform::ID
 public:
-    Shader(const std::string& filepath);
+    Shader(const std::string& filepath, unsigned int variant = 0);
     ~Shader();
 
+    // Move-only: a copy would delete the same program twice.
+    Shader(const Shader&) = delete;
+    Shader& operator=(const Shader&) = delete;
+    Shader(Shader&& other) noexcept;
+    Shader& operator=(Shader&& other) noexcept;
+
     void Bind() const;
     void Unbind() const;
 
+    // False when the program failed to compile or link.
+    bool IsValid() const;
+
     // Set uniforms
-    void SetUniform1i(const std::string& name, int value); // Already exists
-    void SetUniform1f(const std::string& name, float value);
-    void SetUniform4f(const std::string& name, glm::vec4& value);
-    void SetUniformMat4f(const std::string& name, const glm::mat4& matrix);
-    void SetPickingMode(bool pickingMode); // New function to toggle picking mode
+    void SetUniform1i(const Uniform& uniform, int value);
+    void SetUniform1iv(const Uniform& uniform, int count, const int* values);
+    void SetUniform1f(const Uniform& uniform, float value);
+    void SetUniform3i(const Uniform& uniform, const glm::ivec3& value);
+    void SetUniform4f(const Uniform& uniform, const glm::vec4& value);
+    void SetUniformMat4f(const Uniform& uniform, const glm::mat4& matrix);
+
+    inline const std::string& GetFilepath() const { return m_Filepath; }
+    inline unsigned int GetVariant() const { return m_Variant; }
 private:
-    ShaderProgramSource ParseShader(const std::string& filepath);
+    ShaderProgramSource ParseShader(const std::string& filepath, unsigned int variant);
     unsigned int CompileShader(unsigned int type, const std::string& source);
     unsigned int CreateShader(const std::string& vertexShader, const std::string& fragmentShader);
 
-    int GetUniformLocation(const std::string& name);
+    void ReflectUniforms();
+    int GetUniformLocation(const Uniform& uniform);
+    bool UniformChanged(const Uniform& uniform, const void* data, unsigned int size);
 };
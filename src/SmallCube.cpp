@@ -1,12 +1,12 @@
-#include "smallCube.h"
+#include "SmallCube.h"
 
 // Constructor
-SmallCube::SmallCube(const glm::vec3& pos, int index)
-        : index(index), modelMatrix(glm::translate(glm::mat4(1.0f), pos)) ,   RotationMatrix(glm::mat4(1.0f)) {}
+SmallCube::SmallCube(const glm::vec3& pos, int index, const glm::ivec3& slot)
+        : index(index), slot(slot), modelMatrix(glm::translate(glm::mat4(1.0f), pos)) ,   RotationMatrix(glm::mat4(1.0f)), transformDirty(true) {}
 
 
 SmallCube::SmallCube()
-        : index(0), modelMatrix(glm::mat4(1.0f)) {}
+        : index(0), slot(0), modelMatrix(glm::mat4(1.0f)), RotationMatrix(glm::mat4(1.0f)), transformDirty(true) {}
 
 // Getter for position (calculated from modelMatrix)
 glm::vec3 SmallCube::getPosition() const {
@@ -26,8 +26,18 @@ glm::mat4 SmallCube::getRotationMatrix() const
 // Setter for the model matrix (position derived from matrix)
 void SmallCube::setModelMatrix(const glm::mat4 &matrix) {
     modelMatrix = matrix;
+    transformDirty = true;
 }
 
 void SmallCube :: setRotationMatrix ( const glm::mat4 &matrix) {
     this->RotationMatrix = matrix ;
+    transformDirty = true;
+}
+
+bool SmallCube::isTransformDirty() const {
+    return transformDirty;
+}
+
+void SmallCube::clearTransformDirty() {
+    transformDirty = false;
 }
\ No newline at end of file
@@ -10,10 +10,11 @@ class SmallCube {
 public:
     // Model matrix for transformations
     int index ;
+    glm::ivec3 slot ;   // Home grid coordinate (0..2 per axis), used to look up sticker colors
 
 
     // Constructor
-    SmallCube(const glm::vec3& pos , int index);
+    SmallCube(const glm::vec3& pos , int index, const glm::ivec3& slot);
     SmallCube() ;
 
     // Getters
@@ -28,11 +29,17 @@ public:
     void setModelMatrix(const glm::mat4& matrix); // Setter for the model matrix
     void setRotationMatrix(const glm::mat4& matrix); // Setter for the model matrix
 
+    // Set by both setters and cleared by whatever mirrors the transform: the picking boxes of
+    // RubiksCube, or StressScene's transform uploads for the cubes of the grid
+    bool isTransformDirty() const;
+    void clearTransformDirty();
+
 
 
 private :
     glm::mat4 modelMatrix;
     glm::mat4 RotationMatrix  ;
+    bool transformDirty;
 
 
 
@@ -0,0 +1,561 @@
+#include <SoftwareRenderer.h>
+#include <StickerMesh.h>
+
+#include <glm/gtc/packing.hpp>
+#include <stb/stb_image.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SOFTWARE_RENDERER_SSE2
+#include <emmintrin.h>
+#endif
+
+// Sticker colors, indexed by the values stored in CubeState (same table as basic.shader).
+static const glm::vec3 s_Palette[6] = {
+    glm::vec3(1.0f, 0.0f, 0.0f), // Red
+    glm::vec3(1.0f, 0.5f, 0.0f), // Orange
+    glm::vec3(0.0f, 1.0f, 0.0f), // Green
+    glm::vec3(0.0f, 0.0f, 1.0f), // Blue
+    glm::vec3(1.0f, 1.0f, 1.0f), // White
+    glm::vec3(1.0f, 1.0f, 0.0f)  // Yellow
+};
+
+// Float to unorm8 as GL converts color outputs: clamp, then round.
+static unsigned char ToUnorm8(float value)
+{
+    return (unsigned char) (std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+}
+
+static uint32_t PackRGBA(const glm::vec4& color)
+{
+    unsigned char bytes[4] = { ToUnorm8(color.r), ToUnorm8(color.g), ToUnorm8(color.b), ToUnorm8(color.a) };
+    uint32_t packed;
+    std::memcpy(&packed, bytes, sizeof(packed));
+    return packed;
+}
+
+static glm::vec4 UnpackRGBA(uint32_t packed)
+{
+    unsigned char bytes[4];
+    std::memcpy(bytes, &packed, sizeof(bytes));
+    return glm::vec4(bytes[0], bytes[1], bytes[2], bytes[3]) / 255.0f;
+}
+
+SoftwareRenderer::SoftwareRenderer(int width, int height, unsigned int threads)
+    : m_Width(0), m_Height(0), m_Stride(0), m_TilesX(0), m_TilesY(0),
+      m_ClearColor(PackRGBA(glm::vec4(1.0f))), m_ImageDirty(true),
+      m_Generation(0), m_Active(0), m_Stopping(false), m_NextTile(0)
+{
+    for (int color = 0; color < 6; color++)
+    {
+        m_StickerLayers[color] = 0;
+        m_CenterLayers[color] = 0;
+    }
+
+    // The 24 corners shared by every cubie, decoded once from the packed GPU format
+    for (const StickerVertex& vertex : StickerMesh::GetVertices())
+    {
+        glm::vec4 position = glm::unpackSnorm3x10_1x2(vertex.Position.Bits);
+        ClipVertex corner;
+        corner.Position = glm::vec4(0.5f * glm::vec3(position), 1.0f);
+        corner.TexCoord = glm::vec2(vertex.TexCoord[0], vertex.TexCoord[1]) / 255.0f;
+        m_CubeVertices.push_back(corner);
+    }
+
+    Resize(width, height);
+
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (unsigned int i = 1; i < threads; i++)
+        m_Workers.emplace_back(&SoftwareRenderer::WorkerLoop, this);
+    m_Stats.Threads = threads;
+}
+
+SoftwareRenderer::~SoftwareRenderer()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_Start.notify_all();
+    for (std::thread& worker : m_Workers)
+        worker.join();
+}
+
+void SoftwareRenderer::Resize(int width, int height)
+{
+    if (width == m_Width && height == m_Height)
+        return;
+
+    m_Width = width;
+    m_Height = height;
+    // Rows are padded to whole groups of four pixels, so SIMD loads never leave the row
+    m_Stride = (width + 3) & ~3;
+    m_TilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    m_TilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    m_Color.assign((size_t) m_Stride * height, m_ClearColor);
+    m_Depth.assign((size_t) m_Stride * height, 1.0f);
+    m_Bins.assign((size_t) m_TilesX * m_TilesY, std::vector<unsigned int>());
+    m_ImageDirty = true;
+}
+
+void SoftwareRenderer::SetClearColor(const glm::vec4& color)
+{
+    m_ClearColor = PackRGBA(color);
+}
+
+bool SoftwareRenderer::LoadTextures(const std::vector<std::string>& filepaths)
+{
+    bool loaded = true;
+    m_Layers.assign(filepaths.size(), std::vector<TextureLevel>());
+    for (size_t layer = 0; layer < filepaths.size(); layer++)
+    {
+        // Bottom row first, as the GL path uploads it
+        stbi_set_flip_vertically_on_load(1);
+        int width, height, channels;
+        unsigned char* pixels = stbi_load(filepaths[layer].c_str(), &width, &height, &channels, 4);
+        TextureLevel base;
+        if (pixels)
+        {
+            base.Width = width;
+            base.Height = height;
+            base.Texels.resize((size_t) width * height);
+            std::memcpy(base.Texels.data(), pixels, base.Texels.size() * sizeof(uint32_t));
+            stbi_image_free(pixels);
+        }
+        else
+        {
+            std::cout << "Failed to load texture " << filepaths[layer] << std::endl;
+            loaded = false;
+            base.Width = base.Height = 1;
+            base.Texels.assign(1, PackRGBA(glm::vec4(1.0f)));
+        }
+
+        // Box-filtered mipmaps down to 1x1, like glGenerateMipmap
+        std::vector<TextureLevel>& levels = m_Layers[layer];
+        levels.push_back(std::move(base));
+        while (levels.back().Width > 1 || levels.back().Height > 1)
+        {
+            const TextureLevel& source = levels.back();
+            TextureLevel level;
+            level.Width = std::max(source.Width / 2, 1);
+            level.Height = std::max(source.Height / 2, 1);
+            level.Texels.resize((size_t) level.Width * level.Height);
+            for (int y = 0; y < level.Height; y++)
+            {
+                for (int x = 0; x < level.Width; x++)
+                {
+                    int x0 = std::min(2 * x, source.Width - 1), x1 = std::min(2 * x + 1, source.Width - 1);
+                    int y0 = std::min(2 * y, source.Height - 1), y1 = std::min(2 * y + 1, source.Height - 1);
+                    glm::vec4 sum = UnpackRGBA(source.Texels[y0 * source.Width + x0]) + UnpackRGBA(source.Texels[y0 * source.Width + x1])
+                                  + UnpackRGBA(source.Texels[y1 * source.Width + x0]) + UnpackRGBA(source.Texels[y1 * source.Width + x1]);
+                    level.Texels[y * level.Width + x] = PackRGBA(0.25f * sum);
+                }
+            }
+            levels.push_back(std::move(level));
+        }
+    }
+    return loaded;
+}
+
+void SoftwareRenderer::SetLayers(const int stickerLayers[6], const int centerLayers[6])
+{
+    for (int color = 0; color < 6; color++)
+    {
+        m_StickerLayers[color] = stickerLayers[color];
+        m_CenterLayers[color] = centerLayers[color];
+    }
+}
+
+void SoftwareRenderer::Render(const RubiksCube& cube, const glm::mat4& viewProjection)
+{
+    m_Triangles.clear();
+    for (std::vector<unsigned int>& bin : m_Bins)
+        bin.clear();
+
+    // Faces between cubies are hidden unless a wall is stuck part way through a turn.
+    bool midTurn = false;
+    for (int wall = 0; wall < 6; ++wall)
+        midTurn = midTurn || cube.wallAngles[wall] != 0;
+
+    const CubeState& state = cube.cubeState;
+    int size = state.GetSize();
+    for (const SmallCube* smallCube : cube.smallCubes)
+    {
+        glm::mat4 mvp = viewProjection * smallCube->getRotationMatrix() * smallCube->getModelMatrix();
+        const glm::ivec3& slot = smallCube->slot;
+        for (int face = 0; face < FACE_COUNT; face++)
+        {
+            int sticker = state.GetStickerIndex(face, slot);
+            if (sticker == -1 && !midTurn)
+                continue;
+
+            // Faces inside the puzzle are black and untextured
+            glm::vec3 color(0.0f);
+            int layer = -1;
+            int orientation = 0;
+            if (sticker != -1)
+            {
+                int value = state.GetSticker(sticker);
+                glm::ivec2 uv = face < 2 ? glm::ivec2(slot.x, slot.y) : (face < 4 ? glm::ivec2(slot.z, slot.y) : glm::ivec2(slot.x, slot.z));
+                bool center = uv == glm::ivec2(size / 2) && size % 2 == 1;
+                color = s_Palette[value];
+                orientation = state.GetOrientation(sticker);
+                layer = center ? m_CenterLayers[value] : m_StickerLayers[value];
+                if (layer >= (int) m_Layers.size())
+                    layer = -1;
+            }
+
+            ClipVertex corners[4];
+            for (int i = 0; i < 4; i++)
+            {
+                corners[i] = m_CubeVertices[face * 4 + i];
+                corners[i].Position = mvp * corners[i].Position;
+
+                // Turn the image back by the sticker's orientation, as basic.shader does
+                glm::vec2 c = corners[i].TexCoord - 0.5f;
+                for (int step = 0; step < orientation; step++)
+                    c = glm::vec2(c.y, -c.x);
+                corners[i].TexCoord = c + 0.5f;
+            }
+            AddTriangle(corners[0], corners[1], corners[2], color, layer);
+            AddTriangle(corners[2], corners[3], corners[0], color, layer);
+        }
+    }
+    m_Stats.Triangles = (unsigned int) m_Triangles.size();
+
+    // Bin by bounding box; a triangle lands in every tile its box touches
+    m_Stats.BinEntries = 0;
+    for (unsigned int i = 0; i < m_Triangles.size(); i++)
+    {
+        const Triangle& triangle = m_Triangles[i];
+        for (int ty = triangle.MinY / TILE_SIZE; ty <= triangle.MaxY / TILE_SIZE; ty++)
+        {
+            for (int tx = triangle.MinX / TILE_SIZE; tx <= triangle.MaxX / TILE_SIZE; tx++)
+            {
+                m_Bins[ty * m_TilesX + tx].push_back(i);
+                m_Stats.BinEntries++;
+            }
+        }
+    }
+
+    // Every worker and this thread take tiles until none are left
+    m_NextTile = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Generation++;
+        m_Active = (unsigned int) m_Workers.size();
+    }
+    m_Start.notify_all();
+    RasterizeTiles();
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Done.wait(lock, [this]() { return m_Active == 0; });
+    }
+    m_ImageDirty = true;
+}
+
+// Clips against the near plane (z > -w) and hands the pieces to SetupTriangle. The other planes
+// need no clipping: the tiles bound the raster and the depth test rejects anything past far.
+void SoftwareRenderer::AddTriangle(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c, const glm::vec3& color, int layer)
+{
+    const ClipVertex* input[3] = { &a, &b, &c };
+    ClipVertex output[4];
+    int count = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        const ClipVertex& current = *input[i];
+        const ClipVertex& next = *input[(i + 1) % 3];
+        float currentDistance = current.Position.z + current.Position.w;
+        float nextDistance = next.Position.z + next.Position.w;
+        if (currentDistance >= 0.0f)
+            output[count++] = current;
+        if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+        {
+            float t = currentDistance / (currentDistance - nextDistance);
+            output[count].Position = glm::mix(current.Position, next.Position, t);
+            output[count].TexCoord = glm::mix(current.TexCoord, next.TexCoord, t);
+            count++;
+        }
+    }
+
+    for (int i = 1; i + 1 < count; i++)
+    {
+        ClipVertex corners[3] = { output[0], output[i], output[i + 1] };
+        SetupTriangle(corners, color, layer);
+    }
+}
+
+void SoftwareRenderer::SetupTriangle(const ClipVertex* corners, const glm::vec3& color, int layer)
+{
+    // Perspective divide and viewport transform; image rows run top to bottom
+    float x[3], y[3], z[3], invW[3];
+    for (int i = 0; i < 3; i++)
+    {
+        const glm::vec4& position = corners[i].Position;
+        invW[i] = 1.0f / position.w;
+        x[i] = (position.x * invW[i] * 0.5f + 0.5f) * m_Width;
+        y[i] = (0.5f - position.y * invW[i] * 0.5f) * m_Height;
+        z[i] = position.z * invW[i] * 0.5f + 0.5f;
+    }
+
+    // Both windings are drawn; flip clockwise ones so the inside is where every edge is positive
+    float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    int order[3] = { 0, 1, 2 };
+    if (area < 0.0f)
+    {
+        std::swap(order[1], order[2]);
+        area = -area;
+    }
+    if (area < 1e-8f)
+        return;
+
+    Triangle triangle;
+    float minX = (float) m_Width, minY = (float) m_Height, maxX = 0.0f, maxY = 0.0f;
+    for (int i = 0; i < 3; i++)
+    {
+        int v = order[i];
+        minX = std::min(minX, x[v]);
+        minY = std::min(minY, y[v]);
+        maxX = std::max(maxX, x[v]);
+        maxY = std::max(maxY, y[v]);
+    }
+    // Pixels whose centers may be covered
+    triangle.MinX = std::max((int) std::floor(minX - 0.5f), 0);
+    triangle.MinY = std::max((int) std::floor(minY - 0.5f), 0);
+    triangle.MaxX = std::min((int) std::ceil(maxX - 0.5f), m_Width - 1);
+    triangle.MaxY = std::min((int) std::ceil(maxY - 0.5f), m_Height - 1);
+    if (triangle.MinX > triangle.MaxX || triangle.MinY > triangle.MaxY)
+        return;
+
+    // Edge i lies opposite corner i; E_i / area is the barycentric weight of that corner
+    float weightA[3], weightB[3], weightC[3];
+    for (int i = 0; i < 3; i++)
+    {
+        int j = order[(i + 1) % 3], k = order[(i + 2) % 3];
+
+        // A neighbor sharing this edge walks it the other way. Computing the coefficients from
+        // the same endpoint and negating makes its edge values the exact negation of ours, so
+        // a pixel is never lost or drawn twice along the shared edge.
+        bool flip = x[k] < x[j] || (x[k] == x[j] && y[k] < y[j]);
+        int from = flip ? k : j, to = flip ? j : k;
+        float a = y[from] - y[to];
+        float b = x[to] - x[from];
+        float c = -(a * x[from] + b * y[from]);
+        if (flip)
+        {
+            a = -a;
+            b = -b;
+            c = -c;
+        }
+        weightA[i] = a / area;
+        weightB[i] = b / area;
+        weightC[i] = c / area;
+
+        // Fill rule: pixels exactly on a shared edge belong to the triangle for which it is a
+        // top or left edge
+        triangle.EdgeA[i] = a;
+        triangle.EdgeB[i] = b;
+        triangle.EdgeC[i] = c;
+        triangle.TopLeft[i] = a > 0.0f || (a == 0.0f && b < 0.0f);
+    }
+
+    // Attribute planes, interpolated linearly in screen space
+    auto plane = [&](float* out, const float* values) {
+        out[0] = out[1] = out[2] = 0.0f;
+        for (int i = 0; i < 3; i++)
+        {
+            float value = values[order[i]];
+            out[0] += value * weightA[i];
+            out[1] += value * weightB[i];
+            out[2] += value * weightC[i];
+        }
+    };
+    float uOverW[3], vOverW[3];
+    for (int i = 0; i < 3; i++)
+    {
+        uOverW[i] = corners[i].TexCoord.x * invW[i];
+        vOverW[i] = corners[i].TexCoord.y * invW[i];
+    }
+    plane(triangle.Depth, z);
+    plane(triangle.InvW, invW);
+    plane(triangle.UOverW, uOverW);
+    plane(triangle.VOverW, vOverW);
+
+    triangle.Color = color;
+    triangle.Layer = layer;
+    triangle.Level = 0;
+    if (layer != -1)
+    {
+        // One mipmap level per triangle, from its texel area over its pixel area
+        const TextureLevel& base = m_Layers[layer][0];
+        glm::vec2 t0 = corners[0].TexCoord, t1 = corners[1].TexCoord, t2 = corners[2].TexCoord;
+        float texelArea = std::abs((t1.x - t0.x) * (t2.y - t0.y) - (t2.x - t0.x) * (t1.y - t0.y)) * base.Width * base.Height;
+        if (texelArea > area)
+        {
+            float level = 0.5f * std::log2(texelArea / area);
+            triangle.Level = std::min((int) (level + 0.5f), (int) m_Layers[layer].size() - 1);
+        }
+    }
+    m_Triangles.push_back(triangle);
+}
+
+void SoftwareRenderer::RasterizeTiles()
+{
+    int tileCount = m_TilesX * m_TilesY;
+    for (int tile = m_NextTile++; tile < tileCount; tile = m_NextTile++)
+        RasterizeTile(tile);
+}
+
+void SoftwareRenderer::RasterizeTile(int tile)
+{
+    int tileX0 = (tile % m_TilesX) * TILE_SIZE;
+    int tileY0 = (tile / m_TilesX) * TILE_SIZE;
+    int tileX1 = std::min(tileX0 + TILE_SIZE, m_Width);
+    int tileY1 = std::min(tileY0 + TILE_SIZE, m_Height);
+
+    for (int y = tileY0; y < tileY1; y++)
+    {
+        std::fill(m_Color.begin() + (size_t) y * m_Stride + tileX0, m_Color.begin() + (size_t) y * m_Stride + tileX1, m_ClearColor);
+        std::fill(m_Depth.begin() + (size_t) y * m_Stride + tileX0, m_Depth.begin() + (size_t) y * m_Stride + tileX1, 1.0f);
+    }
+
+    for (unsigned int index : m_Bins[tile])
+    {
+        const Triangle& triangle = m_Triangles[index];
+        // Groups of four start on a multiple of four; tiles do too, so a group never spans two tiles
+        int x0 = std::max(triangle.MinX, tileX0) & ~3;
+        int x1 = std::min(triangle.MaxX + 1, tileX1);
+        int y0 = std::max(triangle.MinY, tileY0);
+        int y1 = std::min(triangle.MaxY + 1, tileY1);
+
+        for (int y = y0; y < y1; y++)
+        {
+            float py = y + 0.5f;
+            uint32_t* colorRow = &m_Color[(size_t) y * m_Stride];
+            float* depthRow = &m_Depth[(size_t) y * m_Stride];
+#ifdef SOFTWARE_RENDERER_SSE2
+            const __m128 laneOffsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+            __m128 edgeRow[3], edgeStep[3], edgeTies[3];
+            for (int i = 0; i < 3; i++)
+            {
+                edgeRow[i] = _mm_set1_ps(triangle.EdgeB[i] * py + triangle.EdgeC[i]);
+                edgeStep[i] = _mm_set1_ps(triangle.EdgeA[i]);
+                edgeTies[i] = _mm_castsi128_ps(_mm_set1_epi32(triangle.TopLeft[i] ? -1 : 0));
+            }
+            __m128 depthRowValue = _mm_set1_ps(triangle.Depth[1] * py + triangle.Depth[2]);
+            __m128 depthStep = _mm_set1_ps(triangle.Depth[0]);
+            __m128 zero = _mm_setzero_ps();
+            for (int x = x0; x < x1; x += 4)
+            {
+                __m128 px = _mm_add_ps(_mm_set1_ps((float) x), laneOffsets);
+                __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                for (int i = 0; i < 3; i++)
+                {
+                    __m128 edge = _mm_add_ps(_mm_mul_ps(edgeStep[i], px), edgeRow[i]);
+                    __m128 onEdge = _mm_and_ps(_mm_cmpeq_ps(edge, zero), edgeTies[i]);
+                    inside = _mm_and_ps(inside, _mm_or_ps(_mm_cmpgt_ps(edge, zero), onEdge));
+                }
+                int mask = _mm_movemask_ps(inside);
+                if (!mask)
+                    continue;
+
+                __m128 depth = _mm_add_ps(_mm_mul_ps(depthStep, px), depthRowValue);
+                mask &= _mm_movemask_ps(_mm_cmplt_ps(depth, _mm_loadu_ps(depthRow + x)));
+                // Lanes past the tile belong to the next tile (or to the row padding)
+                mask &= (1 << std::min(x1 - x, 4)) - 1;
+                if (!mask)
+                    continue;
+
+                float depths[4];
+                _mm_storeu_ps(depths, depth);
+                for (int lane = 0; lane < 4; lane++)
+                {
+                    if (mask & (1 << lane))
+                    {
+                        depthRow[x + lane] = depths[lane];
+                        colorRow[x + lane] = Shade(triangle, x + lane + 0.5f, py);
+                    }
+                }
+            }
+#else
+            for (int x = x0; x < x1; x++)
+            {
+                float px = x + 0.5f;
+                bool inside = true;
+                for (int i = 0; i < 3; i++)
+                {
+                    // Same evaluation order as the SIMD path, so both round alike
+                    float edge = triangle.EdgeA[i] * px + (triangle.EdgeB[i] * py + triangle.EdgeC[i]);
+                    inside = inside && (edge > 0.0f || (edge == 0.0f && triangle.TopLeft[i]));
+                }
+                if (!inside)
+                    continue;
+
+                float depth = triangle.Depth[0] * px + triangle.Depth[1] * py + triangle.Depth[2];
+                if (depth < depthRow[x])
+                {
+                    depthRow[x] = depth;
+                    colorRow[x] = Shade(triangle, px, py);
+                }
+            }
+#endif
+        }
+    }
+}
+
+uint32_t SoftwareRenderer::Shade(const Triangle& triangle, float x, float y) const
+{
+    glm::vec4 color(triangle.Color, 1.0f);
+    if (triangle.Layer != -1)
+    {
+        // Perspective-correct texture coordinates, sampled nearest with REPEAT wrapping
+        float w = 1.0f / (triangle.InvW[0] * x + triangle.InvW[1] * y + triangle.InvW[2]);
+        float u = (triangle.UOverW[0] * x + triangle.UOverW[1] * y + triangle.UOverW[2]) * w;
+        float v = (triangle.VOverW[0] * x + triangle.VOverW[1] * y + triangle.VOverW[2]) * w;
+        const TextureLevel& level = m_Layers[triangle.Layer][triangle.Level];
+        int texelX = std::min((int) ((u - std::floor(u)) * level.Width), level.Width - 1);
+        int texelY = std::min((int) ((v - std::floor(v)) * level.Height), level.Height - 1);
+        color *= UnpackRGBA(level.Texels[(size_t) texelY * level.Width + texelX]);
+    }
+    return PackRGBA(color);
+}
+
+void SoftwareRenderer::WorkerLoop()
+{
+    unsigned int generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Start.wait(lock, [&]() { return m_Stopping || m_Generation != generation; });
+            if (m_Stopping)
+                return;
+            generation = m_Generation;
+        }
+
+        RasterizeTiles();
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (--m_Active == 0)
+            m_Done.notify_one();
+    }
+}
+
+const SoftwareImage& SoftwareRenderer::GetImage()
+{
+    if (m_ImageDirty)
+    {
+        m_Image.Width = m_Width;
+        m_Image.Height = m_Height;
+        m_Image.Pixels.resize((size_t) m_Width * m_Height);
+        for (int y = 0; y < m_Height; y++)
+            std::memcpy(&m_Image.Pixels[(size_t) y * m_Width], &m_Color[(size_t) y * m_Stride], m_Width * sizeof(uint32_t));
+        m_ImageDirty = false;
+    }
+    return m_Image;
+}
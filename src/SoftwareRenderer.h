@@ -0,0 +1,124 @@
+#pragma once
+
+#include <RubiksCube.h>
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// RGBA image with 8 bits per channel, top row first. Each pixel's bytes are R, G, B, A in memory.
+struct SoftwareImage
+{
+    int Width = 0, Height = 0;
+    std::vector<uint32_t> Pixels;
+
+    inline const unsigned char* GetData() const { return (const unsigned char*) Pixels.data(); }
+};
+
+struct SoftwareStats
+{
+    unsigned int Triangles = 0;   // After near-plane clipping
+    unsigned int BinEntries = 0;  // Triangle references summed over all tiles
+    unsigned int Threads = 0;     // Including the calling thread
+};
+
+// CPU backend for the scene pass: draws the cube like RubiksCube::draw with basic.shader's
+// TEXTURED variant, without a GL context. Triangles are set up and binned into screen tiles on
+// the calling thread, then the tiles are cleared and rasterized in parallel by a pool of worker
+// threads, four pixels at a time with SSE2 where available. Depth testing matches GL_LESS.
+// The selection outline is not drawn.
+class SoftwareRenderer
+{
+    private:
+        struct Triangle
+        {
+            // Edge functions and attribute planes; 'value = A * x + B * y + C' at a pixel center
+            float EdgeA[3], EdgeB[3], EdgeC[3];
+            bool TopLeft[3];
+            float Depth[3];
+            float InvW[3];
+            float UOverW[3], VOverW[3];
+            glm::vec3 Color;
+            int Layer;        // -1 for faces without a sticker
+            int Level;        // Mipmap level picked from the triangle's texel to pixel ratio
+            int MinX, MinY, MaxX, MaxY;
+        };
+
+        // A clip-space corner with the attributes that are interpolated across the face
+        struct ClipVertex
+        {
+            glm::vec4 Position;
+            glm::vec2 TexCoord;
+        };
+
+        struct TextureLevel
+        {
+            int Width = 0, Height = 0;
+            std::vector<uint32_t> Texels; // Bottom row first, like the GL upload
+        };
+
+        static const int TILE_SIZE = 64;
+
+        int m_Width, m_Height, m_Stride;
+        int m_TilesX, m_TilesY;
+        std::vector<uint32_t> m_Color;
+        std::vector<float> m_Depth;
+        uint32_t m_ClearColor;
+        SoftwareImage m_Image;
+        bool m_ImageDirty;
+
+        std::vector<ClipVertex> m_CubeVertices;
+        std::vector<Triangle> m_Triangles;
+        std::vector<std::vector<unsigned int>> m_Bins;
+        std::vector<std::vector<TextureLevel>> m_Layers;
+        int m_StickerLayers[6];
+        int m_CenterLayers[6];
+        SoftwareStats m_Stats;
+
+        std::vector<std::thread> m_Workers;
+        std::mutex m_Mutex;
+        std::condition_variable m_Start;
+        std::condition_variable m_Done;
+        unsigned int m_Generation;
+        unsigned int m_Active;
+        bool m_Stopping;
+        std::atomic<int> m_NextTile;
+
+        void AddTriangle(const ClipVertex& a, const ClipVertex& b, const ClipVertex& c, const glm::vec3& color, int layer);
+        void SetupTriangle(const ClipVertex* corners, const glm::vec3& color, int layer);
+        void RasterizeTiles();
+        void RasterizeTile(int tile);
+        uint32_t Shade(const Triangle& triangle, float x, float y) const;
+
+        void WorkerLoop();
+    public:
+        // 'threads' counts the calling thread too; 0 uses one per hardware thread.
+        SoftwareRenderer(int width, int height, unsigned int threads = 0);
+        ~SoftwareRenderer();
+
+        SoftwareRenderer(const SoftwareRenderer&) = delete;
+        SoftwareRenderer& operator=(const SoftwareRenderer&) = delete;
+
+        void Resize(int width, int height);
+        void SetClearColor(const glm::vec4& color);
+
+        // Sticker textures, one layer per file, with the same layer tables as basic.shader's
+        // u_StickerLayers and u_CenterLayers. Returns false if a file could not be loaded; the
+        // other layers are still usable.
+        bool LoadTextures(const std::vector<std::string>& filepaths);
+        void SetLayers(const int stickerLayers[6], const int centerLayers[6]);
+
+        // Clears the image and draws the cube into it.
+        void Render(const RubiksCube& cube, const glm::mat4& viewProjection);
+
+        const SoftwareImage& GetImage();
+        inline const SoftwareStats& GetStats() const { return m_Stats; }
+        inline int GetWidth() const { return m_Width; }
+        inline int GetHeight() const { return m_Height; }
+};
@@ -0,0 +1,42 @@
+#include <StickerBuffer.h>
+#include <RenderState.h>
+
+StickerBuffer::StickerBuffer(unsigned int size)
+    : m_BufferID(0), m_TextureID(0), m_Size(size)
+{
+    GLCall(glGenBuffers(1, &m_BufferID));
+    RenderState::BindBuffer(GL_TEXTURE_BUFFER, m_BufferID);
+    GLCall(glBufferData(GL_TEXTURE_BUFFER, size, nullptr, GL_DYNAMIC_DRAW));
+
+    // The texture is only a view of the buffer, so updates never touch the texture object
+    GLCall(glGenTextures(1, &m_TextureID));
+    RenderState::BindTexture(GL_TEXTURE_BUFFER, m_TextureID);
+    GLCall(glTexBuffer(GL_TEXTURE_BUFFER, GL_R8UI, m_BufferID));
+
+    RenderState::BindTexture(GL_TEXTURE_BUFFER, 0);
+    RenderState::BindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+StickerBuffer::~StickerBuffer()
+{
+    RenderState::DeleteTexture(m_TextureID);
+    RenderState::DeleteBuffer(m_BufferID);
+}
+
+void StickerBuffer::Update(const void* data, unsigned int size, unsigned int offset)
+{
+    ASSERT(offset + size <= m_Size);
+    RenderState::BindBuffer(GL_TEXTURE_BUFFER, m_BufferID);
+    GLCall(glBufferSubData(GL_TEXTURE_BUFFER, offset, size, data));
+}
+
+void StickerBuffer::Bind(unsigned int slot) const
+{
+    RenderState::ActiveTexture(slot);
+    RenderState::BindTexture(GL_TEXTURE_BUFFER, m_TextureID);
+}
+
+void StickerBuffer::Unbind() const
+{
+    RenderState::BindTexture(GL_TEXTURE_BUFFER, 0);
+}
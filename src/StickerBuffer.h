@@ -0,0 +1,23 @@
+#pragma once
+
+#include <Debugger.h>
+
+// TBO holding one color index per sticker (GL_R8UI), sampled in basic.shader through u_Stickers.
+class StickerBuffer
+{
+    private:
+        unsigned int m_BufferID;
+        unsigned int m_TextureID;
+        unsigned int m_Size;
+    public:
+        StickerBuffer(unsigned int size);
+        ~StickerBuffer();
+
+        // Overwrites 'size' bytes starting at 'offset'; only the touched range is sent to the GPU.
+        void Update(const void* data, unsigned int size, unsigned int offset = 0);
+
+        void Bind(unsigned int slot = 1) const;
+        void Unbind() const;
+
+        inline unsigned int GetSize() const { return m_Size; }
+};
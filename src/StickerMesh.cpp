@@ -0,0 +1,122 @@
+#include <StickerMesh.h>
+#include <CubeState.h>
+
+StickerMesh::StickerMesh(int size)
+    : m_Size(size), m_IndexBuffer(nullptr), m_VisibleQuadCount(0)
+{
+    Generate();
+}
+
+StickerMesh::~StickerMesh()
+{
+    delete m_IndexBuffer;
+}
+
+void StickerMesh::SetSize(int size)
+{
+    if (size == m_Size)
+        return;
+
+    m_Size = size;
+    Generate();
+}
+
+void StickerMesh::Generate()
+{
+    static const unsigned short quad[6] = { 0, 1, 2, 2, 3, 0 };
+
+    std::vector<unsigned short> indices;
+    indices.reserve(m_Size * m_Size * m_Size * 36);
+    m_Ranges.assign(m_Size * m_Size * m_Size, CubieRange());
+    m_VisibleQuadCount = 0;
+
+    for (int x = 0; x < m_Size; x++)
+    {
+        for (int y = 0; y < m_Size; y++)
+        {
+            for (int z = 0; z < m_Size; z++)
+            {
+                glm::ivec3 slot(x, y, z);
+                CubieRange& range = m_Ranges[(x * m_Size + y) * m_Size + z];
+                range.First = (unsigned int) indices.size();
+
+                // Two passes: faces on the puzzle's surface first, then the hidden ones
+                for (int pass = 0; pass < 2; pass++)
+                {
+                    for (int face = 0; face < FACE_COUNT; face++)
+                    {
+                        glm::ivec3 normal = CubeState::GetFaceNormal(face);
+                        int axis = normal.x != 0 ? 0 : (normal.y != 0 ? 1 : 2);
+                        bool visible = slot[axis] == (normal[axis] > 0 ? m_Size - 1 : 0);
+                        if (visible != (pass == 0))
+                            continue;
+
+                        for (unsigned short corner : quad)
+                            indices.push_back((unsigned short) (face * 4 + corner));
+                    }
+                    if (pass == 0)
+                        range.VisibleCount = (unsigned int) indices.size() - range.First;
+                }
+                range.Count = (unsigned int) indices.size() - range.First;
+                m_VisibleQuadCount += range.VisibleCount / 6;
+            }
+        }
+    }
+
+    delete m_IndexBuffer;
+    m_IndexBuffer = new IndexBuffer(indices.data(), (unsigned int) (indices.size() * sizeof(unsigned short)));
+}
+
+std::vector<StickerVertex> StickerMesh::GetVertices()
+{
+    // Corners of each face in (u, v) order, which is also their texture coordinate
+    static const int corners[4][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+
+    std::vector<StickerVertex> vertices;
+    vertices.reserve(FACE_COUNT * 4);
+    for (int face = 0; face < FACE_COUNT; face++)
+    {
+        glm::ivec3 normal = CubeState::GetFaceNormal(face);
+        int axis = normal.x != 0 ? 0 : (normal.y != 0 ? 1 : 2);
+        // Texture axes: x and y on the front and back, z and y on the sides, x and z on top and bottom
+        int u = axis == 0 ? 2 : 0;
+        int v = axis == 1 ? 2 : 1;
+
+        for (const int* corner : corners)
+        {
+            glm::vec4 position(0.0f);
+            position[axis] = (float) normal[axis];
+            position[u] = corner[0] ? 1.0f : -1.0f;
+            position[v] = corner[1] ? 1.0f : -1.0f;
+
+            StickerVertex vertex;
+            vertex.Position = PackedSnorm(position);
+            vertex.Face = (unsigned char) face;
+            vertex.TexCoord[0] = corner[0] ? 255 : 0;
+            vertex.TexCoord[1] = corner[1] ? 255 : 0;
+            vertex.Padding = 0;
+            vertices.push_back(vertex);
+        }
+    }
+    return vertices;
+}
+
+VertexBufferLayout StickerMesh::GetLayout()
+{
+    VertexBufferLayout layout;
+    layout.Push<PackedSnorm>(4);              // Position
+    layout.Push(GL_UNSIGNED_BYTE, 1, false); // Face index
+    layout.Push<unsigned char>(2);            // Texture coordinates
+    layout.PushPadding(1);
+    return layout;
+}
+
+void StickerMesh::Bind() const
+{
+    m_IndexBuffer->Bind();
+}
+
+const CubieRange& StickerMesh::GetRange(const glm::ivec3& slot) const
+{
+    return m_Ranges[(slot.x * m_Size + slot.y) * m_Size + slot.z];
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <IndexBuffer.h>
+#include <VertexBufferLayout.h>
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// Index range of one cubie in the sticker mesh. The outward-facing quads come first, followed by
+// the faces that touch neighboring cubies; those only show while a layer is part way through a turn.
+struct CubieRange
+{
+    unsigned int First;        // In indices
+    unsigned int VisibleCount; // Indices of the outward-facing quads
+    unsigned int Count;        // Indices of all six faces
+};
+
+// One corner of a cube face, 8 bytes instead of 24 as floats. Positions are the corners of the
+// unit cube scaled by 2, so they are exactly -1 or 1 in the packed format; the shaders halve them.
+struct StickerVertex
+{
+    PackedSnorm Position;
+    unsigned char Face;        // CubeFace, read as an integer
+    unsigned char TexCoord[2]; // Normalized, 0 or 255
+    unsigned char Padding;
+};
+static_assert(sizeof(StickerVertex) == 8, "StickerVertex must stay tightly packed");
+
+// Index buffer over the 24 cube vertices from GetVertices() (four per face, in CubeFace order),
+// laid out per cubie so each cubie can draw just its stickers. Regenerated only when the cube
+// size changes. Indices only address those 24 vertices, so they are always 16-bit.
+class StickerMesh
+{
+    private:
+        int m_Size;
+        std::vector<CubieRange> m_Ranges;
+        IndexBuffer* m_IndexBuffer;
+        unsigned int m_VisibleQuadCount;
+
+        void Generate();
+    public:
+        StickerMesh(int size = 3);
+        ~StickerMesh();
+
+        StickerMesh(const StickerMesh&) = delete;
+        StickerMesh& operator=(const StickerMesh&) = delete;
+
+        void SetSize(int size);
+
+        void Bind() const;
+
+        // Vertex data and attribute layout shared by every cubie: position (location 0), face
+        // (location 1) and texture coordinates (location 2).
+        static std::vector<StickerVertex> GetVertices();
+        static VertexBufferLayout GetLayout();
+
+        // Arguments for glDrawElements over a range
+        inline unsigned int GetIndexType() const { return m_IndexBuffer->GetType(); }
+        inline const void* GetIndexOffset(const CubieRange& range) const
+        {
+            return (const void*) (uintptr_t) (range.First * m_IndexBuffer->GetIndexSize());
+        }
+
+        // Slots run from 0 to size - 1 along every axis, as in CubeState.
+        const CubieRange& GetRange(const glm::ivec3& slot) const;
+
+        inline int GetSize() const { return m_Size; }
+        inline unsigned int GetVisibleQuadCount() const { return m_VisibleQuadCount; }
+        inline unsigned int GetQuadCount() const { return (unsigned int) m_Ranges.size() * 6; }
+};
@@ -0,0 +1,192 @@
+#include <StressScene.h>
+
+#include <cmath>
+#include <cstring>
+
+// Runs of changed puzzles are uploaded together; gaps up to this many unchanged puzzles are
+// folded into the run, as one larger upload is cheaper than many small ones.
+static const unsigned int MAX_UPLOAD_GAP = 4;
+
+// Uniforms set on every draw, resolved once.
+static const Uniform u_CubieIndex("u_CubieIndex");
+
+StressScene::StressScene(unsigned int count, float spacing, const VertexBuffer& cubeVertices, const VertexBufferLayout& layout)
+    : m_StickerBuffer(count * 6 * 9), m_TransformBuffer(count * 27),
+      m_InstanceBuffer(nullptr, count * sizeof(Instance), GL_DYNAMIC_DRAW), m_Random(12345)
+{
+    unsigned int side = (unsigned int) std::ceil(std::sqrt((double) count));
+    float half = (side - 1) * spacing * 0.5f;
+    for (unsigned int i = 0; i < count; i++)
+    {
+        RubiksCube* cube = new RubiksCube();
+        cube->verbose = false;
+        cube->turnSpeed = 0.0f; // Moves apply at once; nothing plays them back
+        m_Cubes.push_back(cube);
+        m_Offsets.push_back(glm::vec3((i % side) * spacing - half, (i / side) * spacing - half, 0.0f));
+    }
+    m_Instances.resize(count);
+    m_Stickers.assign(count * 6 * 9, 0xFF);
+    m_Transforms.assign(count * 27, glm::mat4(0.0f));
+
+    // A sphere around the cube center that holds every cubie, however far a layer has turned
+    int size = m_Cubes.empty() ? 3 : m_Cubes[0]->cubeState.GetSize();
+    m_BoundingRadius = std::sqrt(3.0f) * size * 0.5f;
+
+    m_VertexArray.AddBuffer(cubeVertices, layout);
+    VertexBufferLayout instanceLayout;
+    instanceLayout.Push<float>(4); // Puzzle offset and index
+    m_VertexArray.AddBuffer(m_InstanceBuffer, instanceLayout, 1);
+}
+
+StressScene::~StressScene()
+{
+    for (RubiksCube* cube : m_Cubes)
+        delete cube;
+}
+
+void StressScene::Update()
+{
+    m_Stats.Moves = 0;
+    for (RubiksCube* cube : m_Cubes)
+    {
+        int size = cube->cubeState.GetSize();
+        CubeMove move;
+        move.Axis = (int) (m_Random() % 3);
+        move.Layer = (int) (m_Random() % size);
+        move.QuarterTurns = (m_Random() & 1) ? 1 : -1;
+        if (cube->applyMove(move))
+            m_Stats.Moves++;
+    }
+}
+
+void StressScene::UploadChanges()
+{
+    const unsigned int stickerCount = 6 * 9;
+    const unsigned int cubieCount = 27;
+
+    // Pending runs of changed puzzles, [begin, end); end == 0 while nothing is pending
+    unsigned int stickerBegin = 0, stickerEnd = 0, transformBegin = 0, transformEnd = 0;
+    auto flushStickers = [&]() {
+        unsigned int bytes = (stickerEnd - stickerBegin) * stickerCount;
+        m_StickerBuffer.Update(&m_Stickers[stickerBegin * stickerCount], bytes, stickerBegin * stickerCount);
+        m_Stats.UploadBytes += bytes;
+        stickerEnd = 0;
+    };
+    auto flushTransforms = [&]() {
+        unsigned int matrices = (transformEnd - transformBegin) * cubieCount;
+        m_TransformBuffer.Update(&m_Transforms[transformBegin * cubieCount], matrices, transformBegin * cubieCount);
+        m_Stats.UploadBytes += matrices * (unsigned int) sizeof(glm::mat4);
+        transformEnd = 0;
+    };
+
+    for (unsigned int i = 0; i < m_Cubes.size(); i++)
+    {
+        RubiksCube* cube = m_Cubes[i];
+        if (cube->cubeState.IsDirty())
+        {
+            unsigned char* mirror = &m_Stickers[i * stickerCount];
+            if (std::memcmp(mirror, cube->cubeState.GetStickers(), stickerCount) != 0)
+            {
+                std::memcpy(mirror, cube->cubeState.GetStickers(), stickerCount);
+                if (stickerEnd != 0 && i - stickerEnd > MAX_UPLOAD_GAP)
+                    flushStickers();
+                if (stickerEnd == 0)
+                    stickerBegin = i;
+                stickerEnd = i + 1;
+            }
+            cube->cubeState.ClearDirty();
+        }
+
+        // Quarter turns snap their cubies back home, so most dirty transforms end where they started
+        bool transformsChanged = false;
+        for (SmallCube* cubie : cube->smallCubes)
+        {
+            if (!cubie->isTransformDirty())
+                continue;
+            glm::mat4 model = cubie->getRotationMatrix() * cubie->getModelMatrix();
+            glm::mat4& mirror = m_Transforms[i * cubieCount + cubie->index];
+            if (model != mirror)
+            {
+                mirror = model;
+                transformsChanged = true;
+            }
+            cubie->clearTransformDirty();
+        }
+        if (transformsChanged)
+        {
+            if (transformEnd != 0 && i - transformEnd > MAX_UPLOAD_GAP)
+                flushTransforms();
+            if (transformEnd == 0)
+                transformBegin = i;
+            transformEnd = i + 1;
+        }
+    }
+    if (stickerEnd != 0)
+        flushStickers();
+    if (transformEnd != 0)
+        flushTransforms();
+}
+
+void StressScene::Draw(Shader& shader, const StickerMesh& mesh, const glm::mat4& proj, const glm::mat4& view)
+{
+    m_Stats.Cubes = (unsigned int) m_Cubes.size();
+    m_Stats.DrawCalls = 0;
+    m_Stats.UploadBytes = 0;
+    UploadChanges();
+
+    // Frustum planes (Gribb/Hartmann), normalized so distances compare with the bounding radius
+    glm::mat4 viewProjection = proj * view;
+    glm::vec4 planes[6];
+    for (int i = 0; i < 3; i++)
+    {
+        glm::vec4 row(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+        glm::vec4 w(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+        planes[i * 2] = w + row;
+        planes[i * 2 + 1] = w - row;
+    }
+    for (glm::vec4& plane : planes)
+        plane /= glm::length(glm::vec3(plane));
+
+    unsigned int visible = 0;
+    for (unsigned int i = 0; i < m_Cubes.size(); i++)
+    {
+        glm::vec3 center = m_Offsets[i] + m_Cubes[i]->getPosition();
+        bool inside = true;
+        for (const glm::vec4& plane : planes)
+        {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -m_BoundingRadius)
+            {
+                inside = false;
+                break;
+            }
+        }
+        if (inside)
+            m_Instances[visible++] = { m_Offsets[i], (float) i };
+    }
+    m_Stats.Visible = visible;
+    if (visible == 0)
+        return;
+    m_InstanceBuffer.Update(m_Instances.data(), visible * sizeof(Instance));
+    m_Stats.UploadBytes += visible * (unsigned int) sizeof(Instance);
+
+    m_StickerBuffer.Bind(1);
+    m_TransformBuffer.Bind(2);
+    shader.Bind();
+    m_VertexArray.Bind();
+    mesh.Bind();
+
+    // One instanced draw per cubie position; the center cubie has no visible faces.
+    int size = mesh.GetSize();
+    for (int cubie = 0; cubie < size * size * size; cubie++)
+    {
+        glm::ivec3 slot(cubie / (size * size), (cubie / size) % size, cubie % size);
+        const CubieRange& range = mesh.GetRange(slot);
+        if (range.VisibleCount == 0)
+            continue;
+
+        shader.SetUniform1i(u_CubieIndex, cubie);
+        GLCall(glDrawElementsInstanced(GL_TRIANGLES, range.VisibleCount, mesh.GetIndexType(),
+                                       mesh.GetIndexOffset(range), visible));
+        m_Stats.DrawCalls++;
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <RubiksCube.h>
+#include <StickerMesh.h>
+#include <StickerBuffer.h>
+#include <TransformBuffer.h>
+#include <VertexArray.h>
+#include <VertexBuffer.h>
+#include <VertexBufferLayout.h>
+#include <Shader.h>
+
+#include <glm/glm.hpp>
+
+#include <random>
+#include <vector>
+
+struct StressStats
+{
+    unsigned int Cubes = 0;       // Puzzles in the scene
+    unsigned int Visible = 0;     // Puzzles that survived frustum culling
+    unsigned int DrawCalls = 0;
+    unsigned int Moves = 0;       // Layer turns applied by the last Update
+    unsigned int UploadBytes = 0; // Sticker, transform and instance data sent by the last Draw
+};
+
+// Benchmark scene: a square grid of independent Rubik's Cubes that all keep scrambling.
+// Every cubie position is drawn for all visible puzzles with one instanced draw call; each
+// instance finds its puzzle's stickers and transforms in buffers shared by the whole grid.
+class StressScene
+{
+    private:
+        struct Instance
+        {
+            glm::vec3 Offset; // World position of the puzzle's center
+            float Puzzle;     // Index into m_Cubes, exact as a float up to 2^24
+        };
+
+        std::vector<RubiksCube*> m_Cubes;
+        std::vector<glm::vec3> m_Offsets;
+        std::vector<Instance> m_Instances;
+        std::vector<unsigned char> m_Stickers;  // CPU copies of the GPU buffers, used to find and
+        std::vector<glm::mat4> m_Transforms;    // upload only the ranges that really changed
+
+        StickerBuffer m_StickerBuffer;
+        TransformBuffer m_TransformBuffer;
+        VertexBuffer m_InstanceBuffer;
+        VertexArray m_VertexArray;
+
+        std::mt19937 m_Random;
+        StressStats m_Stats;
+        float m_BoundingRadius;
+
+        void UploadChanges();
+    public:
+        // 'cubeVertices' and 'layout' describe the cubie mesh (see main.cpp); the scene adds its
+        // per-instance attribute after them.
+        StressScene(unsigned int count, float spacing, const VertexBuffer& cubeVertices, const VertexBufferLayout& layout);
+        ~StressScene();
+
+        StressScene(const StressScene&) = delete;
+        StressScene& operator=(const StressScene&) = delete;
+
+        // Applies one random layer turn to every puzzle.
+        void Update();
+
+        void Draw(Shader& shader, const StickerMesh& mesh, const glm::mat4& proj, const glm::mat4& view);
+
+        inline const StressStats& GetStats() const { return m_Stats; }
+        inline float GetExtent() const { return m_Offsets.empty() ? 0.0f : glm::length(m_Offsets.back()); }
+};
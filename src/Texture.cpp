@@ -2,6 +2,7 @@
 #include <stb/stb_image_write.h>
 
 #include <Texture.h>
+#include <RenderState.h>
 
 Texture::Texture(const std::string& filepath)
     : m_RendererID(0), m_Filepath(filepath), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_Components(0)
@@ -16,7 +17,7 @@ Texture::Texture(const std::string& filepath)
     GLCall(glGenTextures(1, &m_RendererID));
 
     // Assigns the texture to a Texture Unit
-    GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+    RenderState::BindTexture(GL_TEXTURE_2D, m_RendererID);
 
     // Configures the type of algorithm that is used to make the image smaller or bigger
     GLCall(glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR));
@@ -33,7 +34,7 @@ Texture::Texture(const std::string& filepath)
 	GLCall(glGenerateMipmap(GL_TEXTURE_2D));
 
     // Unbinds the OpenGL Texture object so that it can't accidentally be modified
-    GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+    RenderState::BindTexture(GL_TEXTURE_2D, 0);
 
     if (m_LocalBuffer)
     {
@@ -44,16 +45,16 @@ Texture::Texture(const std::string& filepath)
 
 Texture::~Texture()
 {
-    GLCall(glDeleteTextures(1, &m_RendererID));
+    RenderState::DeleteTexture(m_RendererID);
 }
 
 void Texture::Bind(unsigned int slot) const
 {
-    GLCall(glActiveTexture(GL_TEXTURE0 + slot));
-    GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+    RenderState::ActiveTexture(slot);
+    RenderState::BindTexture(GL_TEXTURE_2D, m_RendererID);
 }
 
 void Texture::Unbind() const
 {
-    GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+    RenderState::BindTexture(GL_TEXTURE_2D, 0);
 }
\ No newline at end of file
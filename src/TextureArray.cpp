@@ -0,0 +1,48 @@
+#include <TextureArray.h>
+#include <RenderState.h>
+
+TextureArray::TextureArray(unsigned int layerCount)
+    : m_RendererID(0), m_Width(1), m_Height(1), m_LayerCount(layerCount)
+{
+    GLCall(glGenTextures(1, &m_RendererID));
+    RenderState::BindTexture(GL_TEXTURE_2D_ARRAY, m_RendererID);
+    SetParameters();
+
+    std::vector<unsigned char> white(m_LayerCount * 4, 255);
+    GLCall(glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, 1, 1, m_LayerCount, 0, GL_RGBA, GL_UNSIGNED_BYTE, white.data()));
+    GLCall(glGenerateMipmap(GL_TEXTURE_2D_ARRAY));
+
+    RenderState::BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void TextureArray::SetParameters()
+{
+    GLCall(glTexParameterf(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR));
+    GLCall(glTexParameterf(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT));
+}
+
+void TextureArray::Adopt(unsigned int rendererID, int width, int height)
+{
+    RenderState::DeleteTexture(m_RendererID);
+    m_RendererID = rendererID;
+    m_Width = width;
+    m_Height = height;
+}
+
+TextureArray::~TextureArray()
+{
+    RenderState::DeleteTexture(m_RendererID);
+}
+
+void TextureArray::Bind(unsigned int slot) const
+{
+    RenderState::ActiveTexture(slot);
+    RenderState::BindTexture(GL_TEXTURE_2D_ARRAY, m_RendererID);
+}
+
+void TextureArray::Unbind() const
+{
+    RenderState::BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
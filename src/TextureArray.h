@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Debugger.h>
+
+#include <vector>
+
+// Several images in one GL_TEXTURE_2D_ARRAY, one layer per file, each with its own mipmap chain.
+// Shaders pick the layer per face, so switching images costs no binds or extra draws.
+// Layers are filled by a TextureLoader, which resamples every image to the size of the first.
+class TextureArray
+{
+    private:
+        unsigned int m_RendererID;
+        int m_Width, m_Height;
+        unsigned int m_LayerCount;
+    public:
+        // Placeholder with 'layerCount' 1x1 white layers, to be filled by a TextureLoader.
+        TextureArray(unsigned int layerCount);
+        ~TextureArray();
+
+        TextureArray(const TextureArray&) = delete;
+        TextureArray& operator=(const TextureArray&) = delete;
+
+        // Sets the sampling parameters every sticker texture array uses on the bound array.
+        static void SetParameters();
+
+        // Takes ownership of a fully uploaded array texture and deletes the current one.
+        void Adopt(unsigned int rendererID, int width, int height);
+
+        void Bind(unsigned int slot = 0) const;
+        void Unbind() const;
+
+        inline int GetWidth() const { return m_Width; }
+        inline int GetHeight() const { return m_Height; }
+        inline unsigned int GetLayerCount() const { return m_LayerCount; }
+};
@@ -0,0 +1,225 @@
+#include <stb/stb_image.h>
+
+#include <TextureLoader.h>
+#include <RenderState.h>
+
+#include <algorithm>
+#include <cstring>
+
+TextureLoader::TextureLoader(unsigned int threadCount, unsigned int bytesPerFrame)
+    : m_Stopping(false), m_StagingBuffer(0), m_StagingSize(bytesPerFrame), m_BytesPerFrame(bytesPerFrame)
+{
+    GLCall(glGenBuffers(1, &m_StagingBuffer));
+    RenderState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, m_StagingBuffer);
+    GLCall(glBufferData(GL_PIXEL_UNPACK_BUFFER, m_StagingSize, nullptr, GL_STREAM_DRAW));
+    RenderState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    for (unsigned int i = 0; i < threadCount; i++)
+        m_Workers.emplace_back(&TextureLoader::WorkerLoop, this);
+}
+
+TextureLoader::~TextureLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_Condition.notify_all();
+    for (std::thread& worker : m_Workers)
+        worker.join();
+
+    for (ArrayLoad* load : m_Loads)
+    {
+        if (load->TextureID)
+            RenderState::DeleteTexture(load->TextureID);
+        delete load;
+    }
+    RenderState::DeleteBuffer(m_StagingBuffer);
+}
+
+void TextureLoader::Load(TextureArray& target, const std::vector<std::string>& filepaths)
+{
+    if (filepaths.empty())
+        return;
+
+    ArrayLoad* load = new ArrayLoad();
+    load->Target = &target;
+    load->Filepaths = filepaths;
+    load->Layers.resize(filepaths.size());
+    load->Remaining = (unsigned int) filepaths.size();
+    load->Decoded = false;
+    m_Loads.push_back(load);
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (unsigned int layer = 0; layer < filepaths.size(); layer++)
+            m_Jobs.push_back({ load, layer });
+    }
+    m_Condition.notify_all();
+}
+
+void TextureLoader::WorkerLoop()
+{
+    stbi_set_flip_vertically_on_load_thread(1);
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Condition.wait(lock, [this]() { return m_Stopping || !m_Jobs.empty(); });
+            if (m_Stopping)
+                return;
+            job = m_Jobs.front();
+            m_Jobs.pop_front();
+        }
+        Decode(*job.Load, job.Layer);
+    }
+}
+
+void TextureLoader::Decode(ArrayLoad& load, unsigned int layer)
+{
+    Image& image = load.Layers[layer];
+    int components = 0;
+    unsigned char* pixels = stbi_load(load.Filepaths[layer].c_str(), &image.Width, &image.Height, &components, 4);
+    if (pixels)
+    {
+        image.Pixels.assign(pixels, pixels + image.Width * image.Height * 4);
+        stbi_image_free(pixels);
+    }
+    else
+    {
+        std::cout << "Failed to load texture layer " << layer << ": " << load.Filepaths[layer] << std::endl;
+        image.Width = image.Height = 0;
+    }
+
+    // The worker finishing the last layer brings every layer to the size of the first one
+    if (--load.Remaining != 0)
+        return;
+
+    int width = load.Layers[0].Width > 0 ? load.Layers[0].Width : 1;
+    int height = load.Layers[0].Height > 0 ? load.Layers[0].Height : 1;
+    for (Image& other : load.Layers)
+    {
+        if (other.Width == width && other.Height == height)
+            continue;
+
+        std::vector<unsigned char> resized(width * height * 4, 255); // Missing images become white
+        for (int y = 0; other.Width > 0 && y < height; y++)
+        {
+            int sourceY = y * other.Height / height;
+            for (int x = 0; x < width; x++)
+            {
+                int sourceX = x * other.Width / width;
+                std::memcpy(&resized[(y * width + x) * 4], &other.Pixels[(sourceY * other.Width + sourceX) * 4], 4);
+            }
+        }
+        other.Pixels.swap(resized);
+        other.Width = width;
+        other.Height = height;
+    }
+    load.Decoded = true;
+}
+
+// Copies as many rows as the budget allows into the staging buffer and from there into the
+// texture. Returns true once the last row of the last layer has been handed to GL.
+bool TextureLoader::Upload(ArrayLoad& load, unsigned int& budget)
+{
+    struct Chunk
+    {
+        unsigned int Layer;
+        int Row, Count;
+        unsigned int Offset;
+    };
+
+    const int width = load.Layers[0].Width;
+    const int height = load.Layers[0].Height;
+    const unsigned int rowSize = width * 4;
+    const unsigned int layerCount = (unsigned int) load.Layers.size();
+
+    RenderState::ActiveTexture(STAGING_SLOT);
+    if (!load.TextureID)
+    {
+        GLCall(glGenTextures(1, &load.TextureID));
+        RenderState::BindTexture(GL_TEXTURE_2D_ARRAY, load.TextureID);
+        TextureArray::SetParameters();
+        GLCall(glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, layerCount, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+    }
+    RenderState::BindTexture(GL_TEXTURE_2D_ARRAY, load.TextureID);
+    RenderState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, m_StagingBuffer);
+
+    // A single row larger than the staging buffer: grow it, so huge images still make progress
+    if (rowSize > m_StagingSize)
+    {
+        GLCall(glBufferData(GL_PIXEL_UNPACK_BUFFER, rowSize, nullptr, GL_STREAM_DRAW));
+        m_StagingSize = rowSize;
+    }
+
+    // Invalidating lets the driver hand out fresh memory instead of waiting for last frame's copies
+    unsigned char* staging = (unsigned char*) glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, m_StagingSize,
+                                                               GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!staging)
+    {
+        RenderState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return false;
+    }
+
+    // Whole rows only, at least one per frame
+    unsigned int rows = std::max(rowSize, std::min(budget, m_StagingSize)) / rowSize;
+    std::vector<Chunk> chunks;
+    unsigned int offset = 0;
+    while (rows > 0 && load.Layer < layerCount)
+    {
+        int count = std::min((int) rows, height - load.Row);
+        std::memcpy(staging + offset, &load.Layers[load.Layer].Pixels[load.Row * rowSize], count * rowSize);
+        chunks.push_back({ load.Layer, load.Row, count, offset });
+        offset += count * rowSize;
+        rows -= count;
+
+        load.Row += count;
+        if (load.Row == height)
+        {
+            load.Row = 0;
+            load.Layer++;
+        }
+    }
+    GLCall(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+    budget = budget > offset ? budget - offset : 0;
+
+    // With an unpack buffer bound, the pointer argument is an offset into it
+    for (const Chunk& chunk : chunks)
+    {
+        GLCall(glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, chunk.Row, chunk.Layer, width, chunk.Count, 1,
+                               GL_RGBA, GL_UNSIGNED_BYTE, (const void*) (uintptr_t) chunk.Offset));
+    }
+    RenderState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (load.Layer < layerCount)
+        return false;
+
+    GLCall(glGenerateMipmap(GL_TEXTURE_2D_ARRAY));
+    return true;
+}
+
+void TextureLoader::Update()
+{
+    unsigned int budget = m_BytesPerFrame;
+    for (size_t i = 0; i < m_Loads.size() && budget > 0;)
+    {
+        ArrayLoad* load = m_Loads[i];
+        if (!load->Decoded)
+        {
+            i++;
+            continue;
+        }
+
+        load->Frames++;
+        if (!Upload(*load, budget))
+            break;
+
+        load->Target->Adopt(load->TextureID, load->Layers[0].Width, load->Layers[0].Height);
+        std::cout << "Texture array loaded: " << load->Layers.size() << " layers of " << load->Layers[0].Width
+                  << "x" << load->Layers[0].Height << ", uploaded over " << load->Frames << " frame(s)" << std::endl;
+        delete load;
+        m_Loads.erase(m_Loads.begin() + i);
+    }
+}
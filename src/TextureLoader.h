@@ -0,0 +1,82 @@
+#pragma once
+
+#include <Debugger.h>
+#include <TextureArray.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Fills placeholder TextureArrays in the background. Images are decoded (and resampled to the
+// size of the first layer) on worker threads; the render thread then streams the pixels into a
+// new array texture through a pixel unpack buffer, a bounded number of bytes per frame, and
+// swaps it in once every layer and its mipmaps are complete. The placeholder stays visible
+// until then, so nothing on the render thread waits for file IO or decoding.
+class TextureLoader
+{
+    private:
+        struct Image
+        {
+            std::vector<unsigned char> Pixels; // RGBA, bottom row first
+            int Width = 0, Height = 0;
+        };
+
+        struct ArrayLoad
+        {
+            TextureArray* Target;
+            std::vector<std::string> Filepaths;
+            std::vector<Image> Layers;
+            std::atomic<unsigned int> Remaining; // Layers still being decoded
+            std::atomic<bool> Decoded;
+
+            // Upload progress, only touched by the render thread
+            unsigned int TextureID = 0;
+            unsigned int Layer = 0;
+            int Row = 0;
+            unsigned int Frames = 0;
+        };
+
+        struct Job
+        {
+            ArrayLoad* Load;
+            unsigned int Layer;
+        };
+
+        // Texture unit used while uploading, so the units the scene samples from stay untouched
+        static const unsigned int STAGING_SLOT = 15;
+
+        std::vector<std::thread> m_Workers;
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        std::deque<Job> m_Jobs;
+        bool m_Stopping;
+
+        std::vector<ArrayLoad*> m_Loads;
+        unsigned int m_StagingBuffer;
+        unsigned int m_StagingSize;
+        unsigned int m_BytesPerFrame;
+
+        void WorkerLoop();
+        void Decode(ArrayLoad& load, unsigned int layer);
+        bool Upload(ArrayLoad& load, unsigned int& budget);
+    public:
+        // 'bytesPerFrame' bounds the pixel data handed to GL by a single Update.
+        TextureLoader(unsigned int threadCount = 2, unsigned int bytesPerFrame = 4 * 1024 * 1024);
+        ~TextureLoader();
+
+        TextureLoader(const TextureLoader&) = delete;
+        TextureLoader& operator=(const TextureLoader&) = delete;
+
+        // Starts decoding one image per layer of 'target', which must outlive the load.
+        void Load(TextureArray& target, const std::vector<std::string>& filepaths);
+
+        // Continues the uploads; call once per frame on the render thread.
+        void Update();
+
+        // True while any load has not been swapped in yet.
+        bool IsBusy() const { return !m_Loads.empty(); }
+};
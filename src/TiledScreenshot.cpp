@@ -0,0 +1,53 @@
+#include <TiledScreenshot.h>
+#include <PNGStreamWriter.h>
+
+#include <algorithm>
+#include <vector>
+
+glm::mat4 TiledScreenshot::GetTileProjection(const glm::mat4& projection, int width, int height,
+    int x, int y, int tileWidth, int tileHeight)
+{
+    // Scales and shifts the tile's range of normalized device coordinates to [-1, 1]. Applied
+    // in clip space, so it works for perspective and orthographic projections alike.
+    glm::mat4 crop(1.0f);
+    crop[0][0] = (float) width / tileWidth;
+    crop[1][1] = (float) height / tileHeight;
+    crop[3][0] = (float) (width - 2 * x - tileWidth) / tileWidth;
+    crop[3][1] = (float) (height - 2 * y - tileHeight) / tileHeight;
+    return crop * projection;
+}
+
+bool TiledScreenshot::Render(const std::string& filepath, int width, int height, const glm::mat4& projection,
+    const Framebuffer& target, const DrawTile& drawTile, size_t bandBytes)
+{
+    int tileWidth = target.GetWidth();
+    int tileHeight = target.GetHeight();
+    if (width <= 0 || height <= 0 || tileWidth <= 0 || tileHeight <= 0)
+        return false;
+
+    PNGStreamWriter writer(filepath, width, height);
+    if (!writer.IsValid())
+        return false;
+
+    size_t rowSize = (size_t) width * 3;
+    int bandHeight = (int) std::min<size_t>(tileHeight, std::max<size_t>(1, bandBytes / rowSize));
+    std::vector<unsigned char> band(rowSize * bandHeight);
+
+    for (int top = 0; top < height; top += bandHeight)
+    {
+        // The target's top edge lines up with the top of the band; rows below the band are
+        // rendered but not read back
+        int rows = std::min(bandHeight, height - top);
+        int y = height - top - tileHeight;
+        for (int x = 0; x < width; x += tileWidth)
+        {
+            drawTile(GetTileProjection(projection, width, height, x, y, tileWidth, tileHeight));
+            target.ReadPixels(0, tileHeight - rows, std::min(tileWidth, width - x), rows, &band[(size_t) x * 3], width);
+        }
+
+        // GL rows start at the bottom
+        for (int row = rows - 1; row >= 0; row--)
+            writer.WriteRows(&band[row * rowSize], 1, rowSize);
+    }
+    return writer.Close();
+}
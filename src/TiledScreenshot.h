@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Framebuffer.h>
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+// Screenshots larger than any render target. The projection is split into sub-frusta, one per
+// tile of the target, and the tiles are rendered left to right, one band of rows at a time. Each
+// band is streamed into a PNG (see PNGStreamWriter.h) before the next one is rendered, so memory
+// use stays at the target plus one band, whatever the image size.
+class TiledScreenshot
+{
+    public:
+        // Draws the scene into the target with the given projection.
+        using DrawTile = std::function<void(const glm::mat4& projection)>;
+
+        // Renders a 'width' x 'height' image of 'projection' into 'filepath'. 'target' sets the
+        // tile size. A band holds at most 'bandBytes' of RGB rows and never more rows than a tile.
+        static bool Render(const std::string& filepath, int width, int height, const glm::mat4& projection,
+            const Framebuffer& target, const DrawTile& drawTile, size_t bandBytes = 64 * 1024 * 1024);
+
+        // Narrows 'projection' to the 'tileWidth' x 'tileHeight' pixels at (x, y), counted from the
+        // bottom-left corner of a 'width' x 'height' image, so that they fill the whole viewport.
+        static glm::mat4 GetTileProjection(const glm::mat4& projection, int width, int height,
+            int x, int y, int tileWidth, int tileHeight);
+};
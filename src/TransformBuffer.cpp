@@ -0,0 +1,41 @@
+#include <TransformBuffer.h>
+#include <RenderState.h>
+
+TransformBuffer::TransformBuffer(unsigned int count)
+    : m_BufferID(0), m_TextureID(0), m_Count(count)
+{
+    GLCall(glGenBuffers(1, &m_BufferID));
+    RenderState::BindBuffer(GL_TEXTURE_BUFFER, m_BufferID);
+    GLCall(glBufferData(GL_TEXTURE_BUFFER, count * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW));
+
+    GLCall(glGenTextures(1, &m_TextureID));
+    RenderState::BindTexture(GL_TEXTURE_BUFFER, m_TextureID);
+    GLCall(glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_BufferID));
+
+    RenderState::BindTexture(GL_TEXTURE_BUFFER, 0);
+    RenderState::BindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+TransformBuffer::~TransformBuffer()
+{
+    RenderState::DeleteTexture(m_TextureID);
+    RenderState::DeleteBuffer(m_BufferID);
+}
+
+void TransformBuffer::Update(const glm::mat4* matrices, unsigned int count, unsigned int first)
+{
+    ASSERT(first + count <= m_Count);
+    RenderState::BindBuffer(GL_TEXTURE_BUFFER, m_BufferID);
+    GLCall(glBufferSubData(GL_TEXTURE_BUFFER, first * sizeof(glm::mat4), count * sizeof(glm::mat4), matrices));
+}
+
+void TransformBuffer::Bind(unsigned int slot) const
+{
+    RenderState::ActiveTexture(slot);
+    RenderState::BindTexture(GL_TEXTURE_BUFFER, m_TextureID);
+}
+
+void TransformBuffer::Unbind() const
+{
+    RenderState::BindTexture(GL_TEXTURE_BUFFER, 0);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <Debugger.h>
+
+#include <glm/glm.hpp>
+
+// TBO holding one model matrix per cubie as four GL_RGBA32F texels (the matrix columns),
+// fetched in basic.shader through u_Transforms. It persists across frames, so only matrices
+// that changed need to be sent again.
+class TransformBuffer
+{
+    private:
+        unsigned int m_BufferID;
+        unsigned int m_TextureID;
+        unsigned int m_Count;
+    public:
+        TransformBuffer(unsigned int count);
+        ~TransformBuffer();
+
+        // Overwrites 'count' matrices starting at matrix 'first'.
+        void Update(const glm::mat4* matrices, unsigned int count, unsigned int first = 0);
+
+        void Bind(unsigned int slot = 2) const;
+        void Unbind() const;
+
+        inline unsigned int GetCount() const { return m_Count; }
+};
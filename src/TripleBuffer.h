@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+
+// Hands values from one writer thread to one reader thread without locks or waiting. Of the
+// three slots, the writer fills one and the reader reads another; the third holds the latest
+// published value. Publish() and Acquire() swap their own slot with that one, so the reader
+// always switches to the newest complete value and the writer never touches what is being read.
+// Values the reader never acquired are simply overwritten.
+template<typename T>
+class TripleBuffer
+{
+    private:
+        // Set on the shared slot's index once the writer published it, cleared when acquired
+        static const unsigned char FRESH = 4;
+
+        T m_Slots[3];
+        std::atomic<unsigned char> m_Shared;
+        unsigned char m_Write; // Only used by the writer
+        unsigned char m_Read;  // Only used by the reader
+    public:
+        TripleBuffer()
+            : m_Shared(1), m_Write(0), m_Read(2)
+        {
+        }
+
+        TripleBuffer(const TripleBuffer&) = delete;
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+        // Writer: the slot to fill before Publish(). It still holds an older value, so every
+        // field has to be written again; containers keep their storage.
+        inline T& GetWriteSlot() { return m_Slots[m_Write]; }
+
+        void Publish()
+        {
+            m_Write = m_Shared.exchange((unsigned char) (m_Write | FRESH), std::memory_order_acq_rel) & 3;
+        }
+
+        // Reader: switches to the newest published value, if there is one, and returns true then.
+        bool Acquire()
+        {
+            if (!(m_Shared.load(std::memory_order_relaxed) & FRESH))
+                return false;
+            m_Read = m_Shared.exchange(m_Read, std::memory_order_acq_rel) & 3;
+            return true;
+        }
+
+        // Reader: the value acquired last. It stays unchanged until the next Acquire().
+        inline const T& GetReadSlot() const { return m_Slots[m_Read]; }
+};
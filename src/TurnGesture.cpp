@@ -0,0 +1,58 @@
+#include <TurnGesture.h>
+
+#include <cmath>
+
+// Projects a world-space point to window coordinates (origin top left, y down, like the cursor).
+static glm::vec2 ToScreen(const glm::vec3& point, const glm::mat4& viewProjection, const glm::vec2& viewport)
+{
+    glm::vec4 clip = viewProjection * glm::vec4(point, 1.0f);
+    glm::vec2 ndc = glm::vec2(clip) / clip.w;
+    return glm::vec2((ndc.x + 1.0f) * 0.5f * viewport.x, (1.0f - ndc.y) * 0.5f * viewport.y);
+}
+
+bool ResolveTurnGesture(const TurnGestureStart& start, const glm::vec2& cursor, const glm::mat4& puzzleToWorld,
+                        const glm::mat4& viewProjection, const glm::vec2& viewport, float minDistance, CubeMove& move)
+{
+    glm::vec2 drag = cursor - start.Cursor;
+    float length = glm::length(drag);
+    if (length < minDistance)
+        return false;
+    drag /= length;
+
+    int normalAxis = start.Normal.x != 0 ? 0 : (start.Normal.y != 0 ? 1 : 2);
+    glm::vec2 origin = ToScreen(start.Point, viewProjection, viewport);
+
+    // Pick the in-face axis whose on-screen direction is closest to the drag
+    glm::ivec3 dragDirection(0);
+    float bestAlignment = -1.0f;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        if (axis == normalAxis)
+            continue;
+
+        glm::vec3 worldAxis = glm::vec3(puzzleToWorld[axis]);
+        glm::vec2 screenAxis = ToScreen(start.Point + worldAxis * 0.5f, viewProjection, viewport) - origin;
+        float screenLength = glm::length(screenAxis);
+        if (screenLength < 1e-4f)
+            continue; // Seen edge-on
+
+        float alignment = glm::dot(screenAxis / screenLength, drag);
+        if (std::abs(alignment) > bestAlignment)
+        {
+            bestAlignment = std::abs(alignment);
+            dragDirection = glm::ivec3(0);
+            dragDirection[axis] = alignment > 0.0f ? 1 : -1;
+        }
+    }
+    if (bestAlignment < 0.0f)
+        return false;
+
+    // A counterclockwise turn around normal x drag moves the face's points along the drag
+    glm::ivec3 turnAxis(start.Normal.y * dragDirection.z - start.Normal.z * dragDirection.y,
+                        start.Normal.z * dragDirection.x - start.Normal.x * dragDirection.z,
+                        start.Normal.x * dragDirection.y - start.Normal.y * dragDirection.x);
+    move.Axis = turnAxis.x != 0 ? 0 : (turnAxis.y != 0 ? 1 : 2);
+    move.Layer = start.Slot[move.Axis];
+    move.QuarterTurns = turnAxis[move.Axis];
+    return true;
+}
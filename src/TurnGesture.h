@@ -0,0 +1,23 @@
+#pragma once
+
+#include <CubeState.h>
+
+#include <glm/glm.hpp>
+
+// Where a drag-to-turn gesture started: the sticker under the cursor when the button went down.
+struct TurnGestureStart
+{
+    glm::ivec3 Slot;      // Slot of the cubie that was hit
+    glm::ivec3 Normal;    // Normal of the hit face in puzzle space (before the whole-cube rotation)
+    glm::vec3 Point;      // World-space hit point
+    glm::vec2 Cursor;     // Window position of the press, in screen coordinates
+};
+
+// Decides which layer move a drag meant. The drag runs along one of the two puzzle axes spanning
+// the hit face, whichever lines up better on screen; the layer turns around the remaining axis,
+// in the direction that carries the sticker along with the cursor.
+// 'puzzleToWorld' is the whole-cube rotation, 'viewProjection' the camera's matrices and
+// 'viewport' the window size matching the cursor coordinates.
+// Returns false while the drag is shorter than 'minDistance' pixels.
+bool ResolveTurnGesture(const TurnGestureStart& start, const glm::vec2& cursor, const glm::mat4& puzzleToWorld,
+                        const glm::mat4& viewProjection, const glm::vec2& viewport, float minDistance, CubeMove& move);
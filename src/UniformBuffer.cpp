@@ -0,0 +1,33 @@
+#include <UniformBuffer.h>
+#include <RenderState.h>
+
+int UniformBlock::GetBinding(const std::string& name)
+{
+    if (name == "Frame")
+        return Frame;
+    return -1;
+}
+
+UniformBuffer::UniformBuffer(unsigned int size)
+    : m_Size(size)
+{
+    GLCall(glGenBuffers(1, &m_RendererID));
+    RenderState::BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW));
+}
+
+UniformBuffer::~UniformBuffer()
+{
+    RenderState::DeleteBuffer(m_RendererID);
+}
+
+void UniformBuffer::Update(const void* data, unsigned int size, unsigned int offset)
+{
+    RenderState::BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+    GLCall(glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data));
+}
+
+void UniformBuffer::Bind(unsigned int binding) const
+{
+    RenderState::BindBufferBase(GL_UNIFORM_BUFFER, binding, m_RendererID);
+}
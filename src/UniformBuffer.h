@@ -0,0 +1,40 @@
+#pragma once
+
+#include <Debugger.h>
+
+#include <string>
+
+// Binding points of the uniform blocks shared by every shader. Shader assigns each block it
+// recognizes by name to its binding point when the program links.
+namespace UniformBlock
+{
+    enum : unsigned int
+    {
+        Frame = 0 // "Frame": FrameConstants, written once per frame by FramePipeline
+    };
+
+    // Binding point of the block called 'name', or -1 for blocks the engine does not provide.
+    int GetBinding(const std::string& name);
+}
+
+// UBO
+class UniformBuffer
+{
+    private:
+        unsigned int m_RendererID;
+        unsigned int m_Size;
+    public:
+        UniformBuffer(unsigned int size);
+        ~UniformBuffer();
+
+        UniformBuffer(const UniformBuffer&) = delete;
+        UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+        // Overwrites 'size' bytes starting at 'offset'.
+        void Update(const void* data, unsigned int size, unsigned int offset = 0);
+
+        // Attaches the whole buffer to a uniform block binding point.
+        void Bind(unsigned int binding) const;
+
+        inline unsigned int GetSize() const { return m_Size; }
+};
@@ -1,37 +1,43 @@
 #include <VertexArray.h>
 #include <VertexBufferLayout.h>
+#include <RenderState.h>
 
 VertexArray::VertexArray()
+    : m_AttributeCount(0)
 {
     GLCall(glGenVertexArrays(1, &m_RendererID));
 }
 
 VertexArray::~VertexArray()
 {
-    GLCall(glDeleteVertexArrays(1, &m_RendererID));
+    RenderState::DeleteVertexArray(m_RendererID);
 }
         
-void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout)
+void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout, unsigned int divisor)
 {
     Bind();
     vb.Bind();
     const auto& elements = layout.GetElements();
-    unsigned int offset = 0;
     for (unsigned int i = 0; i < elements.size(); i ++)
     {
         const auto& element = elements[i];
-        GLCall(glEnableVertexAttribArray(i));
-        GLCall(glVertexAttribPointer(i, element.count, element.type, element.normalized, layout.GetStride(), (const void*) (uintptr_t) offset));
-        offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
+        unsigned int index = m_AttributeCount + i;
+        GLCall(glEnableVertexAttribArray(index));
+        GLCall(glVertexAttribPointer(index, element.count, element.type, element.normalized, layout.GetStride(), (const void*) (uintptr_t) element.offset));
+        if (divisor != 0)
+        {
+            GLCall(glVertexAttribDivisor(index, divisor));
+        }
     }
+    m_AttributeCount += (unsigned int) elements.size();
 }
 
 void VertexArray::Bind() const
 {
-    GLCall(glBindVertexArray(m_RendererID));
+    RenderState::BindVertexArray(m_RendererID);
 }
 
 void VertexArray::Unbind() const
 {
-    GLCall(glBindVertexArray(0));
+    RenderState::BindVertexArray(0);
 }
\ No newline at end of file
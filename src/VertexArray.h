@@ -9,11 +9,14 @@ class VertexArray
 {
     private:
         unsigned int m_RendererID;
+        unsigned int m_AttributeCount;
     public:
         VertexArray();
         ~VertexArray();
         
-        void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
+        // Attributes are numbered on from the buffers added before. A divisor of 1 advances the
+        // buffer once per instance instead of once per vertex.
+        void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout, unsigned int divisor = 0);
 
         void Bind() const;
         void Unbind() const;
@@ -1,23 +1,30 @@
 #include <VertexBuffer.h>
+#include <RenderState.h>
 
-VertexBuffer::VertexBuffer(const void* data, unsigned int size)
+VertexBuffer::VertexBuffer(const void* data, unsigned int size, unsigned int usage)
 {
     GLCall(glGenBuffers(1, &m_RendererID));
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
-    GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
+    RenderState::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, usage));
 }
 
 VertexBuffer::~VertexBuffer()
 {
-    GLCall(glDeleteBuffers(1, &m_RendererID));
+    RenderState::DeleteBuffer(m_RendererID);
+}
+
+void VertexBuffer::Update(const void* data, unsigned int size, unsigned int offset)
+{
+    RenderState::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+    GLCall(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
 }
 
 void VertexBuffer::Bind() const
 {
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+    RenderState::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 }
 
 void VertexBuffer::Unbind() const
 {
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
+    RenderState::BindBuffer(GL_ARRAY_BUFFER, 0);
 }
\ No newline at end of file
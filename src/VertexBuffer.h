@@ -8,9 +8,12 @@ class VertexBuffer
     private:
         unsigned int m_RendererID;
     public:
-        VertexBuffer(const void* data, unsigned int size);
+        VertexBuffer(const void* data, unsigned int size, unsigned int usage = GL_STATIC_DRAW);
         ~VertexBuffer();
 
+        // Overwrites 'size' bytes starting at 'offset'.
+        void Update(const void* data, unsigned int size, unsigned int offset = 0);
+
         void Bind() const;
         void Unbind() const;
 };
\ No newline at end of file
@@ -1,16 +1,40 @@
 #pragma once
 
 #include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
 
 #include <Debugger.h>
 
+#include <cstdint>
 #include <vector>
 
+// 16-bit float vertex component (GL_HALF_FLOAT); exact for the small integers and halves the
+// cube meshes use.
+struct Half
+{
+    uint16_t Bits;
+
+    Half(float value = 0.0f)
+        : Bits(glm::packHalf1x16(value)) {}
+};
+
+// Four signed normalized components in one 32-bit word, 10:10:10:2 bits from x to w
+// (GL_INT_2_10_10_10_REV). x, y and z keep -1, 0 and 1 exact; w only holds -1, 0 or 1.
+struct PackedSnorm
+{
+    uint32_t Bits;
+
+    PackedSnorm(const glm::vec4& value = glm::vec4(0.0f))
+        : Bits(glm::packSnorm3x10_1x2(value)) {}
+};
+
 struct VertexBufferElement
 {
     unsigned int type;
     unsigned int count;
     unsigned char normalized;
+    unsigned int offset;
 
     static unsigned int GetSizeOfType(unsigned int type)
     {
@@ -21,13 +45,28 @@ struct VertexBufferElement
         case GL_UNSIGNED_INT:
             return 4;
         case GL_UNSIGNED_BYTE:
+        case GL_BYTE:
             return 1;
+        case GL_UNSIGNED_SHORT:
+        case GL_SHORT:
+        case GL_HALF_FLOAT:
+            return 2;
         }
         ASSERT(false);
         return 0;
     }
+
+    // Bytes taken by the whole attribute; packed formats hold all four components in one word.
+    static unsigned int GetSize(unsigned int type, unsigned int count)
+    {
+        if (type == GL_INT_2_10_10_10_REV || type == GL_UNSIGNED_INT_2_10_10_10_REV)
+            return 4;
+        return count * GetSizeOfType(type);
+    }
 };
 
+// Small integer types are normalized to [0, 1] or [-1, 1] by default; Push(type, count, false)
+// hands the shader their integer value instead.
 class VertexBufferLayout
 {
     private:
@@ -44,6 +83,18 @@ class VertexBufferLayout
             static_assert(sizeof(T) == 0, "Unsupported type!");
         }
 
+        void Push(unsigned int type, unsigned int count, bool normalized)
+        {
+            m_Elements.push_back({ type, count, (unsigned char) (normalized ? GL_TRUE : GL_FALSE), m_Stride });
+            m_Stride += VertexBufferElement::GetSize(type, count);
+        }
+
+        // Unused bytes, e.g. to keep the stride a multiple of four.
+        void PushPadding(unsigned int size)
+        {
+            m_Stride += size;
+        }
+
         inline const std::vector<VertexBufferElement> GetElements() const { return m_Elements; }
         inline unsigned int GetStride() const { return m_Stride; }
 };
@@ -51,20 +102,48 @@ class VertexBufferLayout
 template<>
 inline void VertexBufferLayout::Push<float>(unsigned int count)
 {
-    m_Elements.push_back({ GL_FLOAT, count, GL_FALSE });
-    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
+    Push(GL_FLOAT, count, false);
 }
 
 template<>
 inline void VertexBufferLayout::Push<unsigned int>(unsigned int count)
 {
-    m_Elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE });
-    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
+    Push(GL_UNSIGNED_INT, count, false);
 }
 
 template<>
 inline void VertexBufferLayout::Push<unsigned char>(unsigned int count)
 {
-    m_Elements.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE });
-    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
-}
\ No newline at end of file
+    Push(GL_UNSIGNED_BYTE, count, true);
+}
+
+template<>
+inline void VertexBufferLayout::Push<signed char>(unsigned int count)
+{
+    Push(GL_BYTE, count, true);
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned short>(unsigned int count)
+{
+    Push(GL_UNSIGNED_SHORT, count, true);
+}
+
+template<>
+inline void VertexBufferLayout::Push<short>(unsigned int count)
+{
+    Push(GL_SHORT, count, true);
+}
+
+template<>
+inline void VertexBufferLayout::Push<Half>(unsigned int count)
+{
+    Push(GL_HALF_FLOAT, count, false);
+}
+
+// 'count' is ignored: a packed attribute always has four components.
+template<>
+inline void VertexBufferLayout::Push<PackedSnorm>(unsigned int count)
+{
+    Push(GL_INT_2_10_10_10_REV, 4, true);
+}
@@ -4,152 +4,558 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <Debugger.h>
+#include <GLExtensions.h>
 #include <VertexBuffer.h>
 #include <VertexBufferLayout.h>
-#include <IndexBuffer.h>
+#include <StickerMesh.h>
 #include <VertexArray.h>
 #include <Shader.h>
-#include <Texture.h>
+#include <ResourceCache.h>
+#include <TextureArray.h>
+#include <TextureLoader.h>
+#include <CubeRenderer.h>
 #include <Camera.h>
 #include <SmallCube.h>
 #include <RubiksCube.h>
+#include <RenderState.h>
+#include <Framebuffer.h>
+#include <FramePipeline.h>
+#include <PickReadback.h>
+#include <StressScene.h>
+#include <SoftwareRenderer.h>
+#include <HeadlessContext.h>
+#include <FrameCapture.h>
+#include <TiledScreenshot.h>
+#include <FixedTimestep.h>
+#include <FrameSnapshot.h>
+#include <TripleBuffer.h>
+#include <stb/stb_image_write.h>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
 
 // Global Rubik's Cube instance.
 RubiksCube rubiksCube;
 
-// Vertex data for a textured cube (positions, colors, and texture coordinates).
-float vertices[] = {
-        // Front face (Red)
-        -0.5f, -0.5f,  0.5f,   1.0f, 0.0f, 0.0f,   0.0f, 0.0f,  // Bottom-left
-        0.5f, -0.5f,  0.5f,   1.0f, 0.0f, 0.0f,   1.0f, 0.0f,  // Bottom-right
-        0.5f,  0.5f,  0.5f,   1.0f, 0.0f, 0.0f,   1.0f, 1.0f,  // Top-right
-        -0.5f,  0.5f,  0.5f,   1.0f, 0.0f, 0.0f,   0.0f, 1.0f,  // Top-left
-
-        // Back face (Orange)
-        -0.5f, -0.5f, -0.5f,   1.0f, 0.5f, 0.0f,   0.0f, 0.0f,
-        0.5f, -0.5f, -0.5f,   1.0f, 0.5f, 0.0f,   1.0f, 0.0f,
-        0.5f,  0.5f, -0.5f,   1.0f, 0.5f, 0.0f,   1.0f, 1.0f,
-        -0.5f,  0.5f, -0.5f,   1.0f, 0.5f, 0.0f,   0.0f, 1.0f,
-
-        // Left face (Green)
-        -0.5f, -0.5f, -0.5f,   0.0f, 1.0f, 0.0f,   0.0f, 0.0f,
-        -0.5f, -0.5f,  0.5f,   0.0f, 1.0f, 0.0f,   1.0f, 0.0f,
-        -0.5f,  0.5f,  0.5f,   0.0f, 1.0f, 0.0f,   1.0f, 1.0f,
-        -0.5f,  0.5f, -0.5f,   0.0f, 1.0f, 0.0f,   0.0f, 1.0f,
-
-        // Right face (Blue)
-        0.5f, -0.5f, -0.5f,   0.0f, 0.0f, 1.0f,   0.0f, 0.0f,
-        0.5f, -0.5f,  0.5f,   0.0f, 0.0f, 1.0f,   1.0f, 0.0f,
-        0.5f,  0.5f,  0.5f,   0.0f, 0.0f, 1.0f,   1.0f, 1.0f,
-        0.5f,  0.5f, -0.5f,   0.0f, 0.0f, 1.0f,   0.0f, 1.0f,
-
-        // Top face (White)
-        -0.5f,  0.5f, -0.5f,   1.0f, 1.0f, 1.0f,   0.0f, 0.0f,
-        0.5f,  0.5f, -0.5f,   1.0f, 1.0f, 1.0f,   1.0f, 0.0f,
-        0.5f,  0.5f,  0.5f,   1.0f, 1.0f, 1.0f,   1.0f, 1.0f,
-        -0.5f,  0.5f,  0.5f,   1.0f, 1.0f, 1.0f,   0.0f, 1.0f,
-
-        // Bottom face (Yellow)
-        -0.5f, -0.5f, -0.5f,   1.0f, 1.0f, 0.0f,   0.0f, 0.0f,
-        0.5f, -0.5f, -0.5f,   1.0f, 1.0f, 0.0f,   1.0f, 0.0f,
-        0.5f, -0.5f,  0.5f,   1.0f, 1.0f, 0.0f,   1.0f, 1.0f,
-        -0.5f, -0.5f,  0.5f,   1.0f, 1.0f, 0.0f,   0.0f, 1.0f
-};
-
-// Indices for drawing each cube face as two triangles.
-unsigned int indices[] = {
-        // Front face
-        0, 1, 2, 2, 3, 0,
-        // Back face
-        4, 5, 6, 6, 7, 4,
-        // Left face
-        8, 9, 10, 10, 11, 8,
-        // Right face
-        12, 13, 14, 14, 15, 12,
-        // Top face
-        16, 17, 18, 18, 19, 16,
-        // Bottom face
-        20, 21, 22, 22, 23, 20
-};
-
-int main() {
-    // Window and perspective parameters.
-    const unsigned int WIN_WIDTH  = 800;
-    const unsigned int WIN_HEIGHT = 600;
+int main(int argc, char** argv) {
+    // Command line: --stress [count] replaces the single cube with a scrambling grid of cubes.
+    // --software [frames] renders that many frames with the CPU backend instead of opening a
+    // window, reports the frame time and writes the last frame to --output (PNG) if given.
+    // --headless [frames] does the same with the GL renderer on an offscreen context, for servers
+    // without a display. --size WIDTHxHEIGHT sets the window or image size. --capture path records
+    // every frame of the window or headless run (see FrameCapture.h for the formats).
+    // --screenshot WIDTHxHEIGHT renders an image of that size in tiles: at the end of a headless
+    // run into --output, in a window on F12 into --output or screenshot.png.
+    // --tick-rate N sets the simulation ticks per second (60), --no-vsync stops waiting for the
+    // display and --benchmark [seconds] runs uncapped for that long (10), then reports frames and
+    // ticks per second and exits. In a window, input and simulation run on the main thread and
+    // rendering on a thread of its own; they only share the snapshots of FrameSnapshot.h.
+    unsigned int stressCount = 0;
+    unsigned int softwareFrames = 0;
+    unsigned int headlessFrames = 0;
+    unsigned int width = 800, height = 600;
+    unsigned int screenshotWidth = 0, screenshotHeight = 0;
+    double tickRate = 60.0;
+    bool vsync = true;
+    double benchmarkSeconds = 0.0;
+    std::string outputPath;
+    std::string capturePath;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc && argv[i + 1][0] != '-';
+        if (arg == "--stress")
+            stressCount = hasValue ? std::strtoul(argv[++i], nullptr, 10) : 4096;
+        else if (arg == "--software")
+            softwareFrames = hasValue ? std::strtoul(argv[++i], nullptr, 10) : 100;
+        else if (arg == "--headless")
+            headlessFrames = hasValue ? std::strtoul(argv[++i], nullptr, 10) : 100;
+        else if (arg == "--size" && hasValue)
+            std::sscanf(argv[++i], "%ux%u", &width, &height);
+        else if (arg == "--screenshot" && hasValue)
+            std::sscanf(argv[++i], "%ux%u", &screenshotWidth, &screenshotHeight);
+        else if (arg == "--output" && hasValue)
+            outputPath = argv[++i];
+        else if (arg == "--capture" && i + 1 < argc)
+            capturePath = argv[++i]; // May start with '|' but not with '-'
+        else if (arg == "--tick-rate" && hasValue)
+            tickRate = std::max(1.0, std::strtod(argv[++i], nullptr));
+        else if (arg == "--no-vsync")
+            vsync = false;
+        else if (arg == "--benchmark") {
+            benchmarkSeconds = hasValue ? std::strtod(argv[++i], nullptr) : 10.0;
+            vsync = false;
+        }
+    }
+
+    // Perspective parameters.
     const float FOV = 45.0f;
     const float NEAR_PLANE = 0.1f;
-    const float FAR_PLANE  = 100.0f;
+    const float FAR_PLANE  = stressCount ? 1000.0f : 100.0f;
+
+    // Layer of the sticker texture array for each sticker color: plain stickers, and the center
+    // orientation mark on the center stickers.
+    const std::vector<std::string> stickerTextures = { "res/textures/plane.png", "res/textures/center.png" };
+    const int stickerLayers[6] = { 0, 0, 0, 0, 0, 0 };
+    const int centerLayers[6] = { 1, 1, 1, 1, 1, 1 };
+
+    // CPU backend: no window or GL context at all.
+    if (softwareFrames) {
+        Camera camera(width, height, rubiksCube);
+        camera.SetPerspective(FOV, NEAR_PLANE, FAR_PLANE);
+        camera.SetPosition(glm::vec3(0.0f, 0.0f, 10.0f));
+
+        SoftwareRenderer renderer(width, height);
+        renderer.LoadTextures(stickerTextures);
+        renderer.SetLayers(stickerLayers, centerLayers);
 
-    // Initialize GLFW.
-    if (!glfwInit()) {
-        std::cerr << "GLFW initialization failed." << std::endl;
-        return -1;
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned int frame = 0; frame < softwareFrames; frame++)
+            renderer.Render(rubiksCube, camera.GetProjectionMatrix() * camera.GetViewMatrix());
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        const SoftwareStats& stats = renderer.GetStats();
+        std::cout << "Software renderer: " << softwareFrames << " frames, " << elapsed.count() / softwareFrames
+                  << " ms/frame, " << stats.Triangles << " triangles, " << stats.BinEntries << " tile bin entries, "
+                  << stats.Threads << " threads" << std::endl;
+
+        if (!outputPath.empty()) {
+            const SoftwareImage& image = renderer.GetImage();
+            if (!stbi_write_png(outputPath.c_str(), image.Width, image.Height, 4, image.GetData(), image.Width * 4)) {
+                std::cerr << "Failed to write " << outputPath << std::endl;
+                return -1;
+            }
+            std::cout << "Wrote " << outputPath << std::endl;
+        }
+        return 0;
     }
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    // Create the window.
-    GLFWwindow* window = glfwCreateWindow(WIN_WIDTH, WIN_HEIGHT, "OpenGL Rubik's Cube", nullptr, nullptr);
-    if (!window) {
-        std::cerr << "Failed to create GLFW window." << std::endl;
-        glfwTerminate();
-        return -1;
+
+    // GL context: a window, or with --headless an offscreen context that can only draw into
+    // framebuffers. Everything after this is shared.
+    GLFWwindow* window = nullptr;
+    std::unique_ptr<HeadlessContext> headless;
+    // Ends GLFW once main returns, on every path. Declared before the GL objects below, so they
+    // are all destroyed while the window's context still exists.
+    std::unique_ptr<GLFWwindow, void (*)(GLFWwindow*)> windowOwner(nullptr, [](GLFWwindow*) { glfwTerminate(); });
+    if (headlessFrames) {
+        headless.reset(new HeadlessContext());
+        if (!headless->IsValid())
+            return -1;
+        gladLoadGLLoader((GLADloadproc) HeadlessContext::GetProcAddress);
+        GLLoadExtensions((GLADloadproc) HeadlessContext::GetProcAddress);
+    } else {
+        // Initialize GLFW.
+        if (!glfwInit()) {
+            std::cerr << "GLFW initialization failed." << std::endl;
+            return -1;
+        }
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifndef NDEBUG
+        glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE); // Debug builds report GL errors via KHR_debug
+#endif
+
+        // Create the window.
+        window = glfwCreateWindow(width, height, "OpenGL Rubik's Cube", nullptr, nullptr);
+        if (!window) {
+            std::cerr << "Failed to create GLFW window." << std::endl;
+            glfwTerminate();
+            return -1;
+        }
+        windowOwner.reset(window);
+        glfwMakeContextCurrent(window);
+        gladLoadGL();
+        GLLoadExtensions((GLADloadproc) glfwGetProcAddress);
     }
-    glfwMakeContextCurrent(window);
-    gladLoadGL();
-    glfwSwapInterval(1); // Enable VSync
 
     std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
+#ifndef NDEBUG
+    if (!GLEnableDebugOutput())
+        std::cout << "KHR_debug unavailable, checking GL errors with glGetError." << std::endl;
+#endif
 
     // Enable depth testing.
     GLCall(glEnable(GL_DEPTH_TEST));
 
-    // Set up the vertex array, vertex buffer, index buffer, and layout.
+    // Set up the vertex array, vertex buffer, and layout. The 24 packed cube vertices and the
+    // indices both come from the sticker mesh, which only lists the faces that can be seen. The
+    // face index selects the sticker color from the cube state (see CubeState.h).
     VertexArray vao;
-    VertexBuffer vbo(vertices, sizeof(vertices));
-    IndexBuffer ibo(indices, sizeof(indices));
-    VertexBufferLayout layout;
-    layout.Push<float>(3); // Positions
-    layout.Push<float>(3); // Colors
-    layout.Push<float>(2); // Texture coordinates
+    std::vector<StickerVertex> vertices = StickerMesh::GetVertices();
+    VertexBuffer vbo(vertices.data(), (unsigned int) (vertices.size() * sizeof(StickerVertex)));
+    StickerMesh mesh(rubiksCube.cubeState.GetSize());
+    std::cout << "Sticker mesh: " << mesh.GetVisibleQuadCount() << " visible quads of " << mesh.GetQuadCount() << std::endl;
+    VertexBufferLayout layout = StickerMesh::GetLayout();
     vao.AddBuffer(vbo, layout);
 
-    // Load and bind the texture.
-    Texture texture("res/textures/plane.png");
-    texture.Bind();
+    // Sticker textures, one array layer each: plain stickers and the center orientation mark.
+    // They are decoded and uploaded in the background; until then the array holds plain white
+    // placeholder layers. The shaders pick a layer per sticker from slot 0.
+    TextureArray textures((unsigned int) stickerTextures.size());
+    TextureLoader textureLoader;
+    textureLoader.Load(textures, stickerTextures);
+
+    // Sticker colors and cube transforms, sampled by the shader from texture slots 1 and 2 and
+    // only refreshed where they changed.
+    CubeRenderer cubeRenderer(rubiksCube.cubeState.GetStickerCount(), static_cast<unsigned int>(rubiksCube.smallCubes.size()));
 
-    // Initialize and bind the shader.
-    Shader shader("res/shaders/basic.shader");
-    shader.Bind();
+    // Shaders come from the resource cache, which compiles each file once and rebuilds it when
+    // the file changes. The cube shader is compiled per variant on first use; the texture slots
+    // and layer tables are set again after every rebuild.
+    ResourceCache resources;
+    auto configureCubeShader = [&](Shader& cubeShader) {
+        glm::vec4 white(1.0f);
+        cubeShader.Bind();
+        cubeShader.SetUniform1i("u_Stickers", 1);
+        cubeShader.SetUniform1i("u_Transforms", 2);
+        cubeShader.SetUniform4f("u_Color", white);
+        cubeShader.SetUniform1i("u_Size", rubiksCube.cubeState.GetSize());
+        if (cubeShader.GetVariant() & ShaderVariant::TEXTURED) {
+            cubeShader.SetUniform1i("u_Textures", 0);
+            cubeShader.SetUniform1iv("u_StickerLayers", 6, stickerLayers);
+            cubeShader.SetUniform1iv("u_CenterLayers", 6, centerLayers);
+        }
+    };
+    std::shared_ptr<Shader> cubeShaders[ShaderVariant::COUNT];
+    auto getCubeShader = [&](unsigned int variant) -> Shader& {
+        if (!cubeShaders[variant]) {
+            cubeShaders[variant] = resources.GetShader("res/shaders/basic.shader", variant);
+            configureCubeShader(*cubeShaders[variant]);
+        }
+        return *cubeShaders[variant];
+    };
+
+    // Flat-color shader for the selection outline.
+    std::shared_ptr<Shader> outlineShader = resources.GetShader("res/shaders/outline.shader");
 
     // Unbind everything for now.
     vao.Unbind();
     vbo.Unbind();
-    ibo.Unbind();
-    shader.Unbind();
+
+    // Offscreen scene target. Besides the color it holds the object ID of every pixel, which is
+    // read back on right-click in picking mode when GPU picking is enabled (G key).
+    int fbWidth = width, fbHeight = height;
+    if (window)
+        glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+    Framebuffer sceneBuffer(fbWidth, fbHeight, true);
 
     // Initialize the camera and configure its perspective and position.
-    Camera camera(WIN_WIDTH, WIN_HEIGHT, rubiksCube);
+    Camera camera(width, height, rubiksCube);
     camera.SetPerspective(FOV, NEAR_PLANE, FAR_PLANE);
     camera.SetPosition(glm::vec3(0.0f, 0.0f, 10.0f));
-    camera.EnableInputs(window);
+    if (window)
+        camera.EnableInputs(window);
+    PickReadback pickReadback;
+    camera.m_PickReadback = &pickReadback;
+    camera.m_PickingWidth = fbWidth;
+    camera.m_PickingHeight = fbHeight;
+
+    // Stress test: the grid replaces the single cube in the scene pass; picking stays off.
+    std::unique_ptr<StressScene> stressScene;
+    if (stressCount) {
+        stressScene.reset(new StressScene(stressCount, 4.0f, vbo, layout));
+        camera.SetPosition(glm::vec3(0.0f, 0.0f, 60.0f));
+        vsync = false; // Benchmark: do not wait for the display
+        std::cout << "Stress test: " << stressCount << " cubes" << std::endl;
+    }
+
+    // Simulation: the Mixer, cube turns and the stress grid's moves advance in fixed ticks,
+    // whatever the frame rate.
+    FixedTimestep timestep(tickRate);
+    auto simulate = [&](float dt) {
+        camera.Update(dt);
+        rubiksCube.update(dt);
+    };
 
-    // Main render loop.
-    while (!glfwWindowShouldClose(window)) {
-        GLCall(glClearColor(1.0f, 1.0f, 1.0f, 1.0f)); // White background.
-        GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+    // After its ticks the simulation publishes a snapshot of the cube and camera, and frames are
+    // drawn from the newest one: the turning layer at renderAlpha between its last two ticks.
+    TripleBuffer<FrameSnapshot> snapshots;
+    const FrameSnapshot* snapshot = nullptr;
+    float renderAlpha = 1.0f;
+    unsigned int screenshotRequests = 0;
+    auto publish = [&](unsigned long long tick, double tickTime) {
+        FrameSnapshot& next = snapshots.GetWriteSlot();
+        rubiksCube.snapshot(next.Cube);
+        next.View = camera.GetViewMatrix();
+        next.Projection = camera.GetProjectionMatrix();
+        next.ViewportWidth = camera.m_Width;
+        next.ViewportHeight = camera.m_Height;
+        next.FramebufferWidth = fbWidth;
+        next.FramebufferHeight = fbHeight;
+        next.GPUPicking = camera.m_GPUPicking;
+        if (camera.m_ScreenshotRequested) {
+            camera.m_ScreenshotRequested = false;
+            screenshotRequests++;
+        }
+        next.ScreenshotRequests = screenshotRequests;
+        next.Tick = tick;
+        next.TickTime = tickTime;
+        next.TickLength = timestep.GetTickLength();
+        snapshots.Publish();
+    };
 
-        glm::mat4 viewMatrix = camera.GetViewMatrix();
-        glm::mat4 projMatrix = camera.GetProjectionMatrix();
+    // The stress grid is too large to copy every tick, so it belongs to the renderer instead and
+    // makes its moves when a snapshot shows new ticks, at most as many per frame as FixedTimestep
+    // runs.
+    unsigned long long stressTick = 0;
+    auto acquireSnapshot = [&]() {
+        snapshots.Acquire();
+        snapshot = &snapshots.GetReadSlot();
+        if (stressScene) {
+            unsigned long long moves = std::min<unsigned long long>(snapshot->Tick - stressTick, 8);
+            for (unsigned long long move = 0; move < moves; move++)
+                stressScene->Update();
+            stressTick = snapshot->Tick;
+        }
+    };
 
-        // Render the Rubik's Cube.
-        rubiksCube.render(shader, vao, ibo, projMatrix, viewMatrix, window);
+    // Frame passes, run in order: scene, overlay. Both draw into the scene target, which is
+    // then copied to the window.
+    FramePipeline pipeline;
+    pipeline.SetClearColor(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)); // White background.
+    pipeline.SetPass(FramePass::Scene, [&]() {
+        textures.Bind(0);
+        if (stressScene) {
+            Shader& instancedShader = getCubeShader(ShaderVariant::INSTANCED | ShaderVariant::TEXTURED);
+            stressScene->Draw(instancedShader, mesh, snapshot->Projection, snapshot->View);
+            return;
+        }
+        // Object IDs are only written while GPU picking may read them back.
+        unsigned int variant = ShaderVariant::TEXTURED;
+        if (snapshot->GPUPicking)
+            variant |= ShaderVariant::PICKING;
+        cubeRenderer.Draw(snapshot->Cube, getCubeShader(variant), vao, mesh, renderAlpha);
+    }, &sceneBuffer);
+    pipeline.SetPass(FramePass::Overlay, [&]() {
+        cubeRenderer.DrawSelection(snapshot->Cube, *outlineShader, vao, mesh, renderAlpha);
+    }, &sceneBuffer);
+    pipeline.SetPresentSource(&sceneBuffer);
 
-        glfwPollEvents();
+    // Frame recording, read back from the scene target after every frame.
+    std::unique_ptr<FrameCapture> capture;
+    if (!capturePath.empty()) {
+        capture.reset(new FrameCapture(capturePath));
+        if (!capture->IsValid())
+            return -1;
     }
+    auto reportCapture = [&]() { // Once per second, and at the end after a Flush
+        CaptureStats stats = capture->GetStats();
+        std::cout << "Capture: " << stats.Frames << " frames, " << stats.Written << " written, "
+                  << stats.Dropped << " dropped" << std::endl;
+    };
 
-    glfwTerminate();
+    // Tiled screenshot of the current snapshot's view. The camera's projection is widened or narrowed to the
+    // screenshot's aspect ratio, keeping the vertical field of view, and every tile is drawn by
+    // the regular passes into the scene target.
+    auto takeScreenshot = [&](const std::string& path) {
+        int shotWidth = screenshotWidth ? screenshotWidth : 4 * sceneBuffer.GetWidth();
+        int shotHeight = screenshotHeight ? screenshotHeight : 4 * sceneBuffer.GetHeight();
+        float aspectScale = ((float) snapshot->ViewportWidth / snapshot->ViewportHeight) / ((float) shotWidth / shotHeight);
+        glm::mat4 projection = glm::scale(glm::mat4(1.0f), glm::vec3(aspectScale, 1.0f, 1.0f)) * snapshot->Projection;
+
+        auto start = std::chrono::steady_clock::now();
+        bool written = TiledScreenshot::Render(path, shotWidth, shotHeight, projection, sceneBuffer,
+            [&](const glm::mat4& tileProjection) {
+                pipeline.SetCamera(snapshot->View, tileProjection);
+                pipeline.Render(sceneBuffer.GetWidth(), sceneBuffer.GetHeight());
+            });
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (written)
+            std::cout << "Screenshot: " << shotWidth << "x" << shotHeight << " in " << elapsed.count() << " s, wrote " << path << std::endl;
+        else
+            std::cerr << "Screenshot: failed to write " << path << std::endl;
+        return written;
+    };
+
+    // Headless run: a fixed number of frames rendered as fast as possible, timed up to the point
+    // where the GPU has finished them. Every frame is one simulation tick, so runs repeat exactly,
+    // and everything stays on this thread.
+    if (headless) {
+        // Wait for the sticker textures so that every timed frame shows the final image.
+        while (textureLoader.IsBusy()) {
+            textureLoader.Update();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned int frame = 0; frame < headlessFrames; frame++) {
+            RenderState::BeginFrame();
+            simulate(timestep.GetTickLength());
+            publish(frame + 1, 0.0);
+            acquireSnapshot();
+            pipeline.SetCamera(snapshot->View, snapshot->Projection);
+            pipeline.Render(fbWidth, fbHeight);
+            if (capture)
+                capture->Capture(sceneBuffer);
+        }
+        GLCall(glFinish());
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "Headless: " << headlessFrames << " frames at " << fbWidth << "x" << fbHeight << ", "
+                  << elapsed.count() / headlessFrames << " ms/frame on " << glGetString(GL_RENDERER) << std::endl;
+
+        int exitCode = 0;
+        if (screenshotWidth && !outputPath.empty()) {
+            if (!takeScreenshot(outputPath))
+                exitCode = -1;
+        } else if (!outputPath.empty()) {
+            std::vector<unsigned char> pixels((size_t) fbWidth * fbHeight * 4);
+            sceneBuffer.ReadPixels(pixels.data());
+            // GL rows start at the bottom
+            size_t rowSize = (size_t) fbWidth * 4;
+            for (int y = 0; y < fbHeight / 2; y++)
+                std::swap_ranges(&pixels[y * rowSize], &pixels[(y + 1) * rowSize], &pixels[(fbHeight - 1 - y) * rowSize]);
+            if (stbi_write_png(outputPath.c_str(), fbWidth, fbHeight, 4, pixels.data(), fbWidth * 4)) {
+                std::cout << "Wrote " << outputPath << std::endl;
+            } else {
+                std::cerr << "Failed to write " << outputPath << std::endl;
+                exitCode = -1;
+            }
+        }
+        if (capture) {
+            capture->Flush();
+            reportCapture();
+        }
+        return exitCode;
+    }
+
+    // Render thread: owns the GL context from here on and draws the newest snapshot, as often as
+    // the swap interval allows. A slow frame no longer holds up input handling or the ticks.
+    std::atomic<bool> running(true);
+    auto renderLoop = [&]() {
+        glfwMakeContextCurrent(window);
+        glfwSwapInterval(vsync ? 1 : 0); // VSync unless --no-vsync, --benchmark or --stress
+
+        double startTime = glfwGetTime();
+        double lastStatsTime = startTime;
+        double lastFrameTime = lastStatsTime;
+        double frameTimeSum = 0.0;
+        unsigned int frameCount = 0;
+        unsigned long long totalFrames = 0;
+        unsigned long long lastStatsTick = 0;
+        unsigned int screenshotsTaken = 0;
+        while (running) {
+            RenderState::BeginFrame();
+            double now = glfwGetTime();
+            frameTimeSum += now - lastFrameTime;
+            lastFrameTime = now;
+            frameCount++;
+            totalFrames++;
+
+            acquireSnapshot();
+            renderAlpha = (float) glm::clamp((now - snapshot->TickTime) / snapshot->TickLength, 0.0, 1.0);
+
+            // Report the redundant GL state changes filtered out by RenderState once per second.
+            if (now - lastStatsTime >= 1.0) {
+                const RenderStats& stats = RenderState::GetLastFrameStats();
+                std::cout << "GL state calls last frame: " << stats.Issued << " issued, "
+                          << stats.Skipped << " skipped, " << cubeRenderer.GetLastTransformUploadBytes()
+                          << " transform bytes uploaded" << std::endl;
+                if (stressScene) {
+                    const StressStats& stress = stressScene->GetStats();
+                    std::cout << "Stress: " << stress.Visible << "/" << stress.Cubes << " cubes drawn ("
+                              << 100.0f * (stress.Cubes - stress.Visible) / stress.Cubes << "% culled), "
+                              << stress.DrawCalls << " draw calls, " << stress.Moves << " moves, "
+                              << stress.UploadBytes << " bytes uploaded, "
+                              << 1000.0 * frameTimeSum / frameCount << " ms/frame" << std::endl;
+                }
+                if (capture)
+                    reportCapture();
+                std::cout << "Timing: " << frameCount / (now - lastStatsTime) << " frames/s, "
+                          << (snapshot->Tick - lastStatsTick) / (now - lastStatsTime) << " ticks/s" << std::endl;
+                frameTimeSum = 0.0;
+                frameCount = 0;
+                lastStatsTime = now;
+                lastStatsTick = snapshot->Tick;
+
+                // Pick up edited shader files; reloaded ones are new objects, so every handle is
+                // acquired again.
+                if (resources.ReloadChanged() > 0) {
+                    for (unsigned int variant = 0; variant < ShaderVariant::COUNT; variant++) {
+                        if (cubeShaders[variant]) {
+                            cubeShaders[variant] = resources.GetShader("res/shaders/basic.shader", variant);
+                            configureCubeShader(*cubeShaders[variant]);
+                        }
+                    }
+                    outlineShader = resources.GetShader("res/shaders/outline.shader");
+                }
+            }
+
+            sceneBuffer.Resize(snapshot->FramebufferWidth, snapshot->FramebufferHeight);
+
+            // Collect finished picks; the input thread hands them to their callbacks.
+            pickReadback.Poll();
+
+            // Continue streaming textures that finished decoding.
+            textureLoader.Update();
+
+            // Screenshots go first: they reuse the scene target, which the frame then redraws.
+            if (snapshot->ScreenshotRequests != screenshotsTaken) {
+                screenshotsTaken = snapshot->ScreenshotRequests;
+                takeScreenshot(outputPath.empty() ? "screenshot.png" : outputPath);
+            }
+
+            // Render the Rubik's Cube and present the frame.
+            pipeline.SetCamera(snapshot->View, snapshot->Projection);
+            pipeline.Execute(window, snapshot->FramebufferWidth, snapshot->FramebufferHeight);
+            pickReadback.Issue(sceneBuffer);
+            if (capture)
+                capture->Capture(sceneBuffer);
+
+            if (benchmarkSeconds > 0.0 && now - startTime >= benchmarkSeconds) {
+                double elapsed = now - startTime;
+                std::cout << "Benchmark: " << totalFrames << " frames and " << snapshot->Tick << " ticks in "
+                          << elapsed << " s: " << totalFrames / elapsed << " frames/s, "
+                          << snapshot->Tick / elapsed << " ticks/s" << std::endl;
+                running = false;
+                glfwPostEmptyEvent(); // Wakes the main thread
+            }
+        }
+        glfwMakeContextCurrent(nullptr);
+    };
+
+    // Main thread: input and simulation, as GLFW only handles events here. It sleeps until the
+    // next tick is due or input arrives, runs the ticks that are due and publishes a snapshot
+    // after them. Input lands in the next tick.
+    double startTime = glfwGetTime();
+    timestep.Reset(startTime);
+    publish(0, startTime);
+    glfwMakeContextCurrent(nullptr);
+    std::thread renderThread(renderLoop);
+
+    double nextTickTime = startTime + timestep.GetTickLength();
+    while (running && !glfwWindowShouldClose(window)) {
+        glfwWaitEventsTimeout(std::max(0.0, nextTickTime - glfwGetTime()));
+
+        // Picks read back by the render thread change the selection here.
+        pickReadback.Deliver();
+
+        glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+        camera.m_PickingWidth = fbWidth;
+        camera.m_PickingHeight = fbHeight;
+
+        double now = glfwGetTime();
+        unsigned int ticks = timestep.Advance(now);
+        for (unsigned int tick = 0; tick < ticks; tick++)
+            simulate(timestep.GetTickLength());
+        double tickTime = now - timestep.GetAlpha() * timestep.GetTickLength();
+        if (ticks)
+            publish(timestep.GetTickCount(), tickTime);
+        nextTickTime = tickTime + timestep.GetTickLength();
+    }
+    running = false;
+    renderThread.join();
+    glfwMakeContextCurrent(window); // The GL objects are destroyed here on return
+
+    if (capture) {
+        capture->Flush();
+        reportCapture();
+    }
     return 0;
 }
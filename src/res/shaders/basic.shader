@@ -1,36 +1,147 @@
+// Sticker shader for the cube and the stress grid. Variants (see ShaderVariant in Shader.h):
+//   PICKING   - also write the object ID of each fragment to the second color attachment
+//   INSTANCED - draw one puzzle per instance, placed by attribute 3
+//   TEXTURED  - modulate the sticker color with a layer of u_Textures
 #shader vertex
 #version 330
 
-layout(location = 0) in vec3 position;
-layout(location = 1) in vec3 color;
+layout(location = 0) in vec3 position; // Unit cube corner times 2 (see StickerVertex)
+layout(location = 1) in float face;
 layout(location = 2) in vec2 texCoord;
+#ifdef INSTANCED
+layout(location = 3) in vec4 instance; // Puzzle offset (xyz) and puzzle index (w)
+#endif
 
 out vec4 v_Color;
+#ifdef TEXTURED
 out vec2 v_TexCoord;
+flat out int v_Layer;
+#endif
+#ifdef PICKING
+flat out int v_Face;
+flat out int v_ObjectID;
+#endif
 
-uniform mat4 u_MVP;
+// Per-frame constants shared by every shader (FrameConstants in FramePipeline.h).
+layout(std140) uniform Frame
+{
+	mat4 u_View;
+	mat4 u_Projection;
+	mat4 u_ViewProjection;
+	vec4 u_Viewport;
+	float u_Time;
+	float u_DeltaTime;
+	int u_FrameIndex;
+};
+
+uniform int u_CubieIndex;
+uniform int u_Size;
+uniform usamplerBuffer u_Stickers;
+uniform samplerBuffer u_Transforms;
+
+#ifdef TEXTURED
+// Layer of u_Textures for each sticker color; the center stickers have their own table.
+uniform int u_StickerLayers[6];
+uniform int u_CenterLayers[6];
+#endif
+
+// Sticker colors, indexed by the values stored in u_Stickers (see CubeState.h).
+const vec3 palette[6] = vec3[6](
+	vec3(1.0, 0.0, 0.0),  // Red
+	vec3(1.0, 0.5, 0.0),  // Orange
+	vec3(0.0, 1.0, 0.0),  // Green
+	vec3(0.0, 0.0, 1.0),  // Blue
+	vec3(1.0, 1.0, 1.0),  // White
+	vec3(1.0, 1.0, 0.0)   // Yellow
+);
 
 void main()
 {
-	gl_Position = u_MVP *  vec4(position.x, position.y, position.z, 1.0);
-	v_Color = vec4(color.x, color.y, color.z, 1.0);
+#ifdef INSTANCED
+	// Each puzzle owns N^3 consecutive transforms and 6 * N * N consecutive stickers.
+	int puzzle = int(instance.w + 0.5);
+	vec3 offset = instance.xyz;
+#else
+	int puzzle = 0;
+	vec3 offset = vec3(0.0);
+#endif
+
+	// Model matrix columns of this cubie, kept up to date by CubeRenderer::Draw.
+	int base = (puzzle * u_Size * u_Size * u_Size + u_CubieIndex) * 4;
+	mat4 model = mat4(texelFetch(u_Transforms, base), texelFetch(u_Transforms, base + 1),
+	                  texelFetch(u_Transforms, base + 2), texelFetch(u_Transforms, base + 3));
+	gl_Position = u_ViewProjection * vec4((model * vec4(0.5 * position, 1.0)).xyz + offset, 1.0);
+
+	// Cubie indices enumerate the home slots x-major: (x * N + y) * N + z.
+	ivec3 slot = ivec3(u_CubieIndex / (u_Size * u_Size), (u_CubieIndex / u_Size) % u_Size, u_CubieIndex % u_Size);
+
+	// Faces are ordered front, back, left, right, up, down (+Z, -Z, -X, +X, +Y, -Y).
+	int f = int(face + 0.5);
+#ifdef PICKING
+	v_Face = f;
+	v_ObjectID = u_CubieIndex + 1;
+#endif
+#ifdef TEXTURED
 	v_TexCoord = texCoord;
+	v_Layer = 0;
+#endif
+	int axis = f < 2 ? 2 : (f < 4 ? 0 : 1);
+	int boundary = (f == 0 || f == 3 || f == 4) ? u_Size - 1 : 0;
+	if (slot[axis] != boundary)
+	{
+		// Faces inside the puzzle carry no sticker.
+		v_Color = vec4(0.0, 0.0, 0.0, 1.0);
+		return;
+	}
+
+	ivec2 uv = f < 2 ? slot.xy : (f < 4 ? slot.zy : slot.xz);
+	uint value = texelFetch(u_Stickers, (puzzle * 6 + f) * u_Size * u_Size + uv.y * u_Size + uv.x).r;
+	uint color = value & 7u;
+	v_Color = vec4(palette[color], 1.0);
+#ifdef TEXTURED
+	// The image's top is turned from +v towards -u once per orientation step, so the
+	// coordinates are turned back the other way about the sticker's middle.
+	vec2 c = texCoord - 0.5;
+	for (int i = int(value >> 3u) & 3; i > 0; i--)
+		c = vec2(c.y, -c.x);
+	v_TexCoord = c + 0.5;
+	bool center = uv == ivec2(u_Size / 2) && u_Size % 2 == 1;
+	v_Layer = center ? u_CenterLayers[color] : u_StickerLayers[color];
+#endif
 }
 
 #shader fragment
 #version 330
 
 layout(location = 0) out vec4 FragColor;
+#ifdef PICKING
+layout(location = 1) out uint ObjectID;
+#endif
 
 in vec4 v_Color;
+#ifdef TEXTURED
 in vec2 v_TexCoord;
+flat in int v_Layer;
+#endif
+#ifdef PICKING
+flat in int v_Face;
+flat in int v_ObjectID;
+#endif
 
 uniform vec4 u_Color;
-uniform sampler2D u_Texture;
+#ifdef TEXTURED
+uniform sampler2DArray u_Textures;
+#endif
 
 void main()
 {
-	vec4 texColor = texture(u_Texture, v_TexCoord) * u_Color;
-	// gl_FragColor = texColor * v_Color;  // Deprecated
-	FragColor = texColor * v_Color;
-}
\ No newline at end of file
+#ifdef TEXTURED
+	FragColor = texture(u_Textures, vec3(v_TexCoord, v_Layer)) * u_Color * v_Color;
+#else
+	FragColor = u_Color * v_Color;
+#endif
+#ifdef PICKING
+	// Picking ID: (cube index + 1) << 3 | face, decoded by RubiksCube::selectByObjectID.
+	ObjectID = (uint(v_ObjectID) << 3) | uint(v_Face);
+#endif
+}
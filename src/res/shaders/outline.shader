@@ -0,0 +1,28 @@
+// outline.shader: flat color for the selection outline
+#shader vertex
+#version 330 core
+layout(location = 0) in vec3 a_Position; // Unit cube corner times 2 (see StickerVertex)
+// Per-frame constants shared by every shader (FrameConstants in FramePipeline.h).
+layout(std140) uniform Frame
+{
+    mat4 u_View;
+    mat4 u_Projection;
+    mat4 u_ViewProjection;
+    vec4 u_Viewport;
+    float u_Time;
+    float u_DeltaTime;
+    int u_FrameIndex;
+};
+uniform mat4 u_Model;
+void main()
+{
+    gl_Position = u_ViewProjection * u_Model * vec4(0.5 * a_Position, 1.0);
+}
+#shader fragment
+#version 330 core
+uniform vec4 u_Color;
+out vec4 color;
+void main()
+{
+    color = u_Color;
+}